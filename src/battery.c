@@ -17,6 +17,7 @@
 #include "common.h"
 #include "config/tx.h"
 #include "music.h"
+#include "datalog.h"
 
 void PAGE_Test();
 
@@ -44,6 +45,9 @@ u8 BATTERY_Check()
     if (battery < Transmitter.batt_critical && ! (warned & BATTERY_CRITICAL)) {
         PAGE_Test();
         CONFIG_SaveModelIfNeeded();
+#if HAS_DATALOG
+        DATALOG_Flush();
+#endif
         CONFIG_SaveTxIfNeeded();
         STORAGE_WriteEnable(0);  // Disable writing to all banks of SPIFlash
         warned |= BATTERY_CRITICAL;
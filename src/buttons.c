@@ -156,7 +156,8 @@ void exec_callbacks(u32 buttons, enum ButtonFlags flags) {
         if ((ptr->button & buttons) && (ptr->flags & flags)) {
             if(!(flags & BUTTON_RELEASE) || buttonPressed == ptr) {
                 //We only send a release to the button that accepted a press
-                if(ptr->callback(buttons, flags, ptr->data)) {
+                int accepted = ptr->callback(buttons, flags, ptr->data);
+                if(accepted) {
                     //Exit after the 1st action accepts the button
                     buttonPressed = (flags & (BUTTON_PRESS | BUTTON_LONGPRESS)) ? ptr : NULL;
                     return;
@@ -0,0 +1,43 @@
+#ifndef _CHANPACK_H_
+#define _CHANPACK_H_
+
+/* Channel scaling and packing shared by the protocols.
+ * A ChanScale is set up once when the protocol initializes and maps a mixer
+ * value onto the protocol's range with a multiply and a shift.  The result is
+ * identical to the integer division the protocols used to do per channel:
+ *   base + (range * (value - origin)) / div
+ * as long as |value - origin| < 2^32 / div, which holds for any mixer output.
+ */
+struct ChanScale {
+    s32 origin;     // input value which maps to 'base'
+    s32 base;
+    s32 min;        // input is clamped to min..max before scaling
+    s32 max;
+    u32 frac;       // fractional part of |range| / div (0.32 fixed point, rounded up)
+    u16 whole;      // integer part of |range| / div
+    u8 negate;      // range < 0
+};
+
+enum ChanPackOrder {
+    CHANPACK_LSB_FIRST,     // first channel starts at bit 0 of the first byte (SBUS, CRSF)
+    CHANPACK_MSB_FIRST,     // first channel starts at bit 7 of the first byte
+};
+
+void CHANPACK_InitScale(struct ChanScale *scale, s32 origin, s32 base, s32 range, s32 div);
+void CHANPACK_InitRange(struct ChanScale *scale, s32 dest_min, s32 dest_max);
+int CHANPACK_Pack(u8 *dest, const u16 *values, int count, int bits, enum ChanPackOrder order);
+int CHANPACK_PackChannels(u8 *dest, const struct ChanScale *scale, int count, int bits, enum ChanPackOrder order);
+
+static inline s32 CHANPACK_Scale(const struct ChanScale *scale, s32 value)
+{
+    if (value < scale->min)
+        value = scale->min;
+    else if (value > scale->max)
+        value = scale->max;
+    value -= scale->origin;
+    u32 mag = value < 0 ? -value : value;
+    u32 delta = mag * scale->whole + (u32)(((u64)mag * scale->frac) >> 32);
+    return (value < 0) != scale->negate ? scale->base - (s32)delta : scale->base + (s32)delta;
+}
+
+#endif  // _CHANPACK_H_
@@ -39,3 +39,113 @@ s32 CHAN_ReadInput(int channel)
     value = value ? CHAN_MAX_VALUE : CHAN_MIN_VALUE;
     return value;
 }
+
+/* The calibration is turned into a zero point and a Q16 scale factor for each
+ * side of it whenever it changes, so normalizing an input needs no divides */
+struct InputScale {
+    s32 zero;
+    s32 pos;
+    s32 neg;
+};
+static struct InputScale input_scale[INP_HAS_CALIBRATION];
+
+struct InputFilter {
+    s32 iir;        // in 1/16ths of an input step
+    s16 hist[4];    // previous samples for the median filters, newest first
+    u8 primed;
+};
+static struct InputFilter input_filter[INP_HAS_CALIBRATION];
+
+void CHAN_UpdateCalibration()
+{
+    for (int i = 0; i < INP_HAS_CALIBRATION; i++) {
+        s32 max = Transmitter.calibration[i].max;
+        s32 min = Transmitter.calibration[i].min;
+        s32 zero = Transmitter.calibration[i].zero;
+        if (!zero) {
+            // If this input doesn't have a zero, calculate from max/min
+            zero = ((u32)max + min) / 2;
+        }
+        // Derate min and max by 1% to ensure we can get all the way to 100%
+        max = (max - zero) * 99 / 100;
+        min = (min - zero) * 99 / 100;
+        input_scale[i].zero = zero;
+        input_scale[i].pos = max ? CHAN_MAX_VALUE * 65536 / max : 0;
+        input_scale[i].neg = min ? CHAN_MIN_VALUE * 65536 / min : 0;
+        // Restart the filter so a changed mode does not start from stale history
+        input_filter[i].primed = 0;
+    }
+}
+
+s32 CHAN_ScaleInput(int channel, s32 value)
+{
+    const struct InputScale *scale = &input_scale[channel - 1];
+    value -= scale->zero;
+    value = ((int64_t)value * (value >= 0 ? scale->pos : scale->neg)) >> 16;
+    // Bound output
+    if (value > CHAN_MAX_VALUE)
+        value = CHAN_MAX_VALUE;
+    if (value < CHAN_MIN_VALUE)
+        value = CHAN_MIN_VALUE;
+    return value;
+}
+
+static s32 median3(s32 a, s32 b, s32 c)
+{
+    s32 lo = a < b ? a : b;
+    s32 hi = a < b ? b : a;
+    return c < lo ? lo : c > hi ? hi : c;
+}
+
+static s32 median5(s32 value, const s16 *hist)
+{
+    s32 v[5] = {value, hist[0], hist[1], hist[2], hist[3]};
+    for (int i = 1; i < 5; i++) {
+        s32 x = v[i];
+        int j = i;
+        for (; j > 0 && v[j - 1] > x; j--)
+            v[j] = v[j - 1];
+        v[j] = x;
+    }
+    return v[2];
+}
+
+/* Called once per new oversampled reading of an input.  The IIR modes trade
+ * latency for noise rejection, the median modes reject single sample spikes
+ * while still following steps after (taps + 1) / 2 samples */
+s32 CHAN_FilterInput(int channel, s32 value)
+{
+    struct InputFilter *f = &input_filter[channel - 1];
+    u8 mode = Transmitter.calibration[channel - 1].filter;
+    if (mode == ADC_FILTER_NONE)
+        return value;
+    if (!f->primed) {
+        // First sample since the filter was reset: start out settled
+        f->iir = value * 16;
+        for (int i = 0; i < 4; i++)
+            f->hist[i] = value;
+        f->primed = 1;
+    }
+    s32 result;
+    switch (mode) {
+    case ADC_FILTER_IIR2:
+    case ADC_FILTER_IIR4:
+    case ADC_FILTER_IIR8:
+        f->iir += (value * 16 - f->iir) >> (mode - ADC_FILTER_IIR2 + 1);
+        return (f->iir + 8) >> 4;
+    case ADC_FILTER_MEDIAN3:
+        result = median3(value, f->hist[0], f->hist[1]);
+        break;
+    default:
+        result = median5(value, f->hist);
+        break;
+    }
+    f->hist[3] = f->hist[2];
+    f->hist[2] = f->hist[1];
+    f->hist[1] = f->hist[0];
+    f->hist[0] = value;
+    return result;
+}
+
+#define TESTNAME chanutils
+#include <tests.h>
@@ -58,6 +58,11 @@ int CONFIG_IniParse(const char* filename,
 u8 CONFIG_IsModelChanged();
 u8 CONFIG_SaveModelIfNeeded();
 void CONFIG_SaveTxIfNeeded();
+/* Bumped wherever Model or Transmitter is written (GUI value callbacks,
+ * mixer and trim setters, timers, protocols), so periodic save checks
+ * only need to CRC the config after it has moved */
+extern volatile u16 config_generation;
+#define CONFIG_MarkChanged() (config_generation++)
 extern const char * const MODULE_NAME[TX_MODULE_LAST];
 
 /* LCD primitive functions */
@@ -91,6 +96,8 @@ void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h,
 void LCD_DrawImageFromFile(u16 x, u16 y, const char *file);
 u8 LCD_ImageIsTransparent(const char *file);
 u8 LCD_ImageDimensions(const char *file, u16 *w, u16 *h);
+void LCD_ImageCacheReset();
+void FONT_CacheReset();
 void LCD_DrawUSBLogo(int lcd_width, int lcd_height);
 
 /* Music */
@@ -177,6 +184,7 @@ int PROTOCOL_SetSwitch(int module);
 int PROTOCOL_SticksMoved(int init);
 void PROTOCOL_InitModules();
 void PROTOCOL_ResetTelemetry();
+void PROTOCOL_ProcessTelemetry();
 enum Radio PROTOCOL_GetRadio(u16 idx);
 int PROTOCOL_RangeTest(int on);
 
@@ -196,11 +204,24 @@ int INPUT_SelectAbbrevSource(int src, int dir);
 
 const char *INPUT_MapSourceName(unsigned idx, unsigned *val);
 const char *INPUT_ButtonName(unsigned src);
+enum {
+    INPUT_NAME_SOURCE = 0x01,
+    INPUT_NAME_SWITCH = 0x02,  //Abbreviated switch name
+    INPUT_NAME_STICK  = 0x04,
+    INPUT_NAME_ALIAS  = 0x08,  //Legacy source name
+    INPUT_NAME_BUTTON = 0x10,
+};
+int INPUT_FindName(const char *name, unsigned types);
 void INPUT_CheckChanges(void);
 
 /* Misc */
 void Delay(u32 count);
 u32 Crc(const void *buffer, u32 size);
+u32 CrcUpdate(u32 crc, const void *buffer, u32 size);
+u8 Crc8Update(u8 crc, const void *buffer, u32 size);
+u8 Crc8DvbS2Update(u8 crc, const void *buffer, u32 size);
+u16 Crc16CcittUpdate(u16 crc, const void *buffer, u32 size);
+u16 Crc16FrskyUpdate(u16 crc, const void *buffer, u32 size);
 const char *utf8_to_u32(const char *str, u32 *ch);
 int exact_atoi(const char *str); //Like atoi but will not decode a number followed by non-number
 size_t strlcpy(char* dst, const char* src, size_t bufsize);
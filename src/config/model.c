@@ -268,49 +268,57 @@ s8 mapstrcasecmp(const char *s1, const char *s2)
 static u8 get_source(const char *section, const char *value)
 {
     unsigned i;
-    unsigned val;
+    int src;
     const char *ptr = (value[0] == '!') ? value + 1 : value;
-    const char *tmp;
     char cmp[10];
-    for (i = 0; i <= NUM_SOURCES; i++) {
-        if(mapstrcasecmp(INPUT_SourceNameReal(cmp, i), ptr) == 0) {
-            #if defined(HAS_SWITCHES_NOSTOCK) && HAS_SWITCHES_NOSTOCK
-            #define SWITCH_NOSTOCK ((1 << INP_HOLD0) | (1 << INP_HOLD1) | \
-                                    (1 << INP_FMOD0) | (1 << INP_FMOD1))
-            if ((Transmitter.ignore_src & SWITCH_NOSTOCK) == SWITCH_NOSTOCK) {
-                if(mapstrcasecmp("FMODE0", ptr) == 0 ||
-                   mapstrcasecmp("FMODE1", ptr) == 0 ||
-                   mapstrcasecmp("HOLD0", ptr) == 0 ||
-                   mapstrcasecmp("HOLD1", ptr) == 0)
-                    break;
+
+    src = INPUT_FindName(ptr, INPUT_NAME_SOURCE);
+#if defined(HAS_SWITCHES_NOSTOCK) && HAS_SWITCHES_NOSTOCK
+    #define SWITCH_NOSTOCK ((1 << INP_HOLD0) | (1 << INP_HOLD1) | \
+                            (1 << INP_FMOD0) | (1 << INP_FMOD1))
+    if (src >= 0 && (Transmitter.ignore_src & SWITCH_NOSTOCK) == SWITCH_NOSTOCK) {
+        if(mapstrcasecmp("FMODE0", ptr) == 0 ||
+           mapstrcasecmp("FMODE1", ptr) == 0 ||
+           mapstrcasecmp("HOLD0", ptr) == 0 ||
+           mapstrcasecmp("HOLD1", ptr) == 0)
+            src = -1;
+    }
+#endif //HAS_SWITCHES_NOSTOCK
+    if (src < 0)
+        src = INPUT_FindName(ptr, INPUT_NAME_STICK | INPUT_NAME_ALIAS);
+    if (src < 0 && Transmitter.language) {
+        //Names saved while the translation was active
+        for (i = 0; i <= NUM_SOURCES; i++) {
+            if(mapstrcasecmp(INPUT_SourceNameReal(cmp, i), ptr) == 0) {
+                src = i;
+                break;
             }
-            #endif //HAS_SWITCHES_NOSTOCK
-            return ((ptr == value) ? 0 : 0x80) | i;
-        }
-    }
-    for (i = 0; i < 4; i++) {
-        if(mapstrcasecmp(tx_stick_names[i], ptr) == 0) {
-            return ((ptr == value) ? 0 : 0x80) | (i + 1);
-        }
-    }
-    i = 0;
-    while((tmp = INPUT_MapSourceName(i++, &val))) {
-        if(mapstrcasecmp(tmp, ptr) == 0) {
-            return ((ptr == value) ? 0 : 0x80) | val;
         }
     }
+    if (src >= 0)
+        return ((ptr == value) ? 0 : 0x80) | src;
     printf("%s: Could not parse Source %s\n", section, value);
     return 0;
 }
 
-static u8 get_button(const char *section, const char *value)
+/* Matches the abbreviated switch names used by toggles and trims:
+ * 'FMODE' selects the first FMODE position, other sources use their full name */
+static int get_abbrev_source(const char *value)
 {
-    u8 i;
-    for (i = 0; i <= NUM_TX_BUTTONS; i++) {
-        if(strcasecmp(INPUT_ButtonName(i), value) == 0) {
-            return i;
-        }
+    int src = INPUT_FindName(value, INPUT_NAME_SWITCH);
+    if (src < 0) {
+        src = INPUT_FindName(value, INPUT_NAME_SOURCE);
+        if (src > 0 && src <= NUM_TX_INPUTS && INPUT_SwitchPos(src) >= 0)
+            src = -1;
     }
+    return src;
+}
+
+static u8 get_button(const char *section, const char *value)
+{
+    int button = INPUT_FindName(value, INPUT_NAME_BUTTON);
+    if (button >= 0)
+        return button;
     printf("%s: Could not parse Button %s\n", section, value);
     return 0;
 }
@@ -552,13 +560,9 @@ static int layout_ini_handler(void* user, const char* section, const char* name,
         {
             if(count)
                 return 1;
-            for (int j = 0; j <= NUM_SOURCES; j++) {
-                char cmp[10];
-                if(mapstrcasecmp(INPUT_SourceNameAbbrevSwitchReal(cmp, j), ptr+1) == 0) {
-                    data[5] = j;
-                    break;
-                }
-            }
+            int src = get_abbrev_source(ptr+1);
+            if (src >= 0)
+                data[5] = src;
             break;
         }
     }
@@ -889,13 +893,9 @@ int assign_int(void* ptr, const struct struct_map *map, int map_size)
         if(assign_int(&m->trims[idx], _sectrim, MAPSIZE(_sectrim)))
             return 1;
         if (MATCH_KEY(TRIM_SWITCH)) {
-            for (int i = 0; i <= NUM_SOURCES; i++) {
-                char cmp[10];
-                if(mapstrcasecmp(INPUT_SourceNameAbbrevSwitchReal(cmp, i), value) == 0) {
-                    m->trims[idx].sw = i;
-                    return 1;
-                }
-            }
+            int src = get_abbrev_source(value);
+            if (src >= 0)
+                m->trims[idx].sw = src;
             return 1;
         }
         if (MATCH_KEY(TRIM_VALUE)) {
@@ -1138,6 +1138,333 @@ static void get_model_file(char *file, u8 model_num)
         sprintf(file, "models/model%d.ini", model_num);
 }
 
+/* Binary model cache
+ * models/modelN.bin holds the Model exactly as ini_handler() left it, so a
+ * model whose ini file hasn't changed can be loaded without parsing it.
+ * The snapshot is only used if the ini CRC, the transmitter, the firmware
+ * build and the Transmitter settings the parser consults (ignored sources,
+ * language) all match, otherwise the ini file is parsed and the cache
+ * rewritten.
+ * Filesystems that can't create files need the .bin preallocated (see Makefile)
+ */
+static void clear_model(u8 full);
+
+#define MODEL_CACHE_MAGIC   0x434d5644  // "DVMC"
+#define MODEL_CACHE_VERSION 2
+struct model_cache_hdr {
+    u32 magic;
+    u32 ini_crc;
+    u32 build_crc;
+    u16 model_size;
+    u8 version;
+    u8 txid;
+    u8 auto_map;
+    u8 language;
+    u8 padding_1[2];
+    srcsize_t ignore_src;
+};
+
+static u32 ini_file_crc(const char *file)
+{
+    u8 buf[64];
+    u32 crc = 0;
+    int len;
+    FILE *fh = fopen(file, "r");
+    if (! fh)
+        return 0;
+    setbuf(fh, 0);
+    while ((len = fread(buf, 1, sizeof(buf), fh)) > 0)
+        crc = CrcUpdate(crc, buf, len);
+    fclose(fh);
+    return crc;
+}
+
+static void fill_cache_hdr(struct model_cache_hdr *hdr, u32 ini_crc)
+{
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = MODEL_CACHE_MAGIC;
+    hdr->ini_crc = ini_crc;
+    hdr->build_crc = Crc(DeviationVersion, strlen(DeviationVersion));
+    hdr->model_size = sizeof(Model);
+    hdr->version = MODEL_CACHE_VERSION;
+    hdr->txid = TXID;
+    hdr->auto_map = auto_map;
+    hdr->language = Transmitter.language;
+    hdr->ignore_src = Transmitter.ignore_src;
+}
+
+static u8 read_model_cache(u8 model_num, u32 ini_crc)
+{
+    char file[20];
+    struct model_cache_hdr hdr, expected;
+    FILE *fh;
+    u8 ok = 0;
+
+    if (model_num == 0 || ini_crc == 0)
+        return 0;
+    sprintf(file, "models/model%d.bin", model_num);
+    fh = fopen(file, "r");
+    if (! fh)
+        return 0;
+    setbuf(fh, 0);
+    if (fread(&hdr, sizeof(hdr), 1, fh) == 1) {
+        auto_map = hdr.auto_map;
+        fill_cache_hdr(&expected, ini_crc);
+        if (memcmp(&hdr, &expected, sizeof(hdr)) == 0)
+            ok = fread(&Model, sizeof(Model), 1, fh) == 1;
+    }
+    fclose(fh);
+    if (! ok) {
+        auto_map = 0;
+        clear_model(1);
+        return 0;
+    }
+    PROTOCOL_Load(1);
+    return 1;
+}
+
+static void write_model_cache(u8 model_num, u32 ini_crc)
+{
+    char file[20];
+    struct model_cache_hdr hdr;
+    FILE *fh;
+
+    if (model_num == 0 || ini_crc == 0)
+        return;
+    sprintf(file, "models/model%d.bin", model_num);
+    fh = fopen(file, "w");
+    if (! fh)
+        return;
+    setbuf(fh, 0);
+    fill_cache_hdr(&hdr, ini_crc);
+    if (fwrite(&hdr, sizeof(hdr), 1, fh) != 1 || fwrite(&Model, sizeof(Model), 1, fh) != 1) {
+        //Don't leave a header behind that would match a truncated model
+        fseek(fh, 0, SEEK_SET);
+        hdr.magic = 0;
+        fwrite(&hdr, sizeof(hdr), 1, fh);
+    }
+    fclose(fh);
+}
+
+#if MODEL_CATALOG_SIZE
+/* Model catalog
+ * models/catalog.bin holds the name, icon, type and protocol of each
+ * models/modelN.ini along with the ini CRC they were taken from, so the model
+ * list doesn't have to open and parse every model file.  It is read into RAM
+ * once and CONFIG_WriteModel() keeps the entry of the model it writes current.
+ * Only USB access can change an ini behind our back, so the header is marked
+ * 'clean' until then and the entries are trusted as they are.  After USB
+ * access each entry is checked against the CRC of its ini the first time it is
+ * used and rebuilt if it differs, and the catalog is marked clean again once
+ * every entry has been checked.
+ * The list draws entries from its label callbacks, so nothing here writes to
+ * the file except CONFIG_WriteModel(), CONFIG_ModelCatalogFlush() (when the
+ * list is closed) and CONFIG_ModelCatalogReset().  The catalog fits in a
+ * single flash sector, which has to be erased and rewritten whatever part of
+ * it changes, so it is written in one piece, and only when it changed.
+ * Models past MODEL_CATALOG_SIZE have no entry and are listed the slow way */
+#define MODEL_CATALOG_FILE    "models/catalog.bin"
+#define MODEL_CATALOG_MAGIC   0x54435644  // "DVCT"
+#define MODEL_CATALOG_VERSION 2
+struct model_catalog_hdr {
+    u32 magic;
+    u16 entry_size;
+    u8 version;
+    u8 entries;
+    u8 count;           // model files present when the catalog was written
+    u8 clean;           // entries match their ini files, no need to check them
+    u8 padding_1[2];
+};
+
+static struct {
+    struct model_catalog_hdr hdr;
+    struct ModelCatalogEntry entry[MODEL_CATALOG_SIZE];
+    u8 loaded;
+    u8 dirty;           // RAM differs from the file
+} catalog;
+
+static int model_exists(u8 model_num)
+{
+    char file[20];
+    get_model_file(file, model_num);
+    FILE *fh = fopen(file, "r");
+    if (! fh)
+        return 0;
+    fclose(fh);
+    return 1;
+}
+
+static void catalog_write()
+{
+    catalog.dirty = 0;
+    FILE *fh = fopen(MODEL_CATALOG_FILE, "w");
+    if (! fh)
+        return;
+    setbuf(fh, 0);
+    catalog.hdr.magic = MODEL_CATALOG_MAGIC;
+    catalog.hdr.entry_size = sizeof(struct ModelCatalogEntry);
+    catalog.hdr.version = MODEL_CATALOG_VERSION;
+    catalog.hdr.entries = MODEL_CATALOG_SIZE;
+    if (fwrite(&catalog.hdr, sizeof(catalog.hdr), 1, fh) != 1
+        || fwrite(catalog.entry, sizeof(catalog.entry), 1, fh) != 1)
+    {
+        struct model_catalog_hdr hdr = catalog.hdr;
+        fseek(fh, 0, SEEK_SET);
+        hdr.magic = 0;
+        fwrite(&hdr, sizeof(hdr), 1, fh);
+    }
+    fclose(fh);
+}
+
+static void catalog_load()
+{
+    u8 ok = 0;
+    FILE *fh = fopen(MODEL_CATALOG_FILE, "r");
+    if (fh) {
+        setbuf(fh, 0);
+        ok = fread(&catalog.hdr, sizeof(catalog.hdr), 1, fh) == 1
+             && catalog.hdr.magic == MODEL_CATALOG_MAGIC
+             && catalog.hdr.version == MODEL_CATALOG_VERSION
+             && catalog.hdr.entry_size == sizeof(struct ModelCatalogEntry)
+             && catalog.hdr.entries == MODEL_CATALOG_SIZE
+             && fread(catalog.entry, sizeof(catalog.entry), 1, fh) == 1;
+        fclose(fh);
+    }
+    if (! ok) {
+        memset(&catalog.hdr, 0, sizeof(catalog.hdr));
+        memset(catalog.entry, 0, sizeof(catalog.entry));
+    }
+    for (int i = 0; i < MODEL_CATALOG_SIZE; i++)
+        catalog.entry[i].checked = catalog.hdr.clean;
+    catalog.loaded = 1;
+    catalog.dirty = ! ok;
+    //Model files may have been added or removed, but the stored count only
+    //needs two probes to confirm
+    u8 count = catalog.hdr.count;
+    if (count && model_exists(count) && ! model_exists(count + 1))
+        return;
+    int num_models;
+    for (num_models = 1; num_models <= 255; num_models++) {
+        if (! model_exists(num_models))
+            break;
+        CLOCK_ResetWatchdog();
+    }
+    catalog.hdr.count = num_models - 1;
+    catalog.dirty = 1;
+}
+
+static int catalog_ini_handler(void* user, const char* section, const char* name, const char* value)
+{
+    struct ModelCatalogEntry *entry = (struct ModelCatalogEntry *)user;
+    if (MATCH_SECTION("")) {
+        if (MATCH_KEY(MODEL_NAME))
+            strlcpy(entry->name, value, sizeof(entry->name));
+        else if (MATCH_KEY(MODEL_ICON))
+            strlcpy(entry->icon, value, sizeof(entry->icon));
+        else if (MATCH_KEY(MODEL_TYPE))
+            entry->type = CONFIG_ParseModelType(value);
+    } else if (MATCH_SECTION(SECTION_RADIO) && MATCH_KEY(RADIO_PROTOCOL)) {
+        for (unsigned i = 0; i < PROTOCOL_COUNT; i++) {
+            if (MATCH_VALUE(PROTOCOL_GetName(i))) {
+                entry->protocol = i;
+                break;
+            }
+        }
+    }
+    return 1;
+}
+
+static void catalog_update(u8 model_num, const struct Model *m, u32 ini_crc)
+{
+    if (! catalog.loaded)
+        catalog_load();
+    if (model_num > catalog.hdr.count) {
+        catalog.hdr.count = model_num;
+        catalog.dirty = 1;
+    }
+    if (model_num <= MODEL_CATALOG_SIZE) {
+        struct ModelCatalogEntry *entry = &catalog.entry[model_num - 1];
+        struct ModelCatalogEntry update;
+        memset(&update, 0, sizeof(update));
+        update.ini_crc = entry->ini_crc;
+        strlcpy(update.name, m->name, sizeof(update.name));
+        if (m->icon[0])
+            strlcpy(update.icon, m->icon + 9, sizeof(update.icon));
+        update.type = m->type;
+        update.protocol = m->protocol;
+        update.checked = entry->checked;
+        //Most saves only change the mixers.  The stored CRC is only looked at
+        //after USB access, when a stale one costs no more than a reparse, so
+        //a new CRC alone doesn't make the catalog worth rewriting
+        if (memcmp(&update, entry, sizeof(update)) != 0)
+            catalog.dirty = 1;
+        *entry = update;
+        entry->ini_crc = ini_crc;
+        entry->checked = 1;
+    }
+    CONFIG_ModelCatalogFlush();
+}
+
+int CONFIG_ModelCount()
+{
+    if (! catalog.loaded)
+        catalog_load();
+    return catalog.hdr.count;
+}
+
+const struct ModelCatalogEntry *CONFIG_GetModelCatalog(u8 model_num)
+{
+    if (! catalog.loaded)
+        catalog_load();
+    if (model_num == 0 || model_num > MODEL_CATALOG_SIZE || model_num > catalog.hdr.count)
+        return NULL;
+    struct ModelCatalogEntry *entry = &catalog.entry[model_num - 1];
+    if (! entry->checked) {
+        char file[20];
+        get_model_file(file, model_num);
+        u32 ini_crc = ini_file_crc(file);
+        if (! ini_crc)
+            return NULL;
+        if (ini_crc != entry->ini_crc) {
+            memset(entry, 0, sizeof(*entry));
+            CONFIG_IniParse(file, catalog_ini_handler, entry);
+            entry->ini_crc = ini_crc;
+            catalog.dirty = 1;
+        }
+        entry->checked = 1;
+    }
+    return entry;
+}
+
+void CONFIG_ModelCatalogFlush()
+{
+    if (! catalog.loaded)
+        return;
+    u8 clean = 1;
+    for (int i = 0; i < catalog.hdr.count && i < MODEL_CATALOG_SIZE; i++) {
+        if (! catalog.entry[i].checked)
+            clean = 0;
+    }
+    if (catalog.dirty || clean != catalog.hdr.clean) {
+        catalog.hdr.clean = clean;
+        catalog_write();
+    }
+}
+
+void CONFIG_ModelCatalogReset()
+{
+    //Called before the PC gets the drive:  the entries have to be checked
+    //after this, even if the next load is after a power cycle
+    if (! catalog.loaded)
+        catalog_load();
+    if (catalog.dirty || catalog.hdr.clean) {
+        catalog.hdr.clean = 0;
+        catalog_write();
+    }
+    catalog.loaded = 0;
+}
+#endif  // MODEL_CATALOG_SIZE
+
 static void write_int(FILE *fh, void* ptr, const struct struct_map *map, int map_size)
 {
     char tmpstr[20];
@@ -1460,6 +1787,13 @@ u8 CONFIG_WriteModel(u8 model_num) {
 #endif
     CONFIG_EnableLanguage(1);
     fclose(fh);
+#if MODEL_CATALOG_SIZE
+    if (model_num) {
+        //file was used as scratch space while writing
+        get_model_file(file, model_num);
+        catalog_update(model_num, m, ini_file_crc(file));
+    }
+#endif
     return 1;
 }
 
@@ -1504,8 +1838,13 @@ u8 CONFIG_ReadModel(u8 model_num) {
     char file[30];
     auto_map = 0;
     get_model_file(file, model_num);
-    if (CONFIG_IniParse(file, ini_handler, &Model)) {
-        printf("Failed to parse Model file: %s\n", file);
+    u32 ini_crc = ini_file_crc(file);
+    if (! read_model_cache(model_num, ini_crc)) {
+        if (CONFIG_IniParse(file, ini_handler, &Model)) {
+            printf("Failed to parse Model file: %s\n", file);
+        } else {
+            write_model_cache(model_num, ini_crc);
+        }
     }
     if (! ELEM_USED(Model.pagecfg2.elem[0]))
         CONFIG_ReadLayout("layout/default.ini");
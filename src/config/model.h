@@ -80,6 +80,7 @@ extern struct Model Model;
 u8 radio_tx_power_int(enum Radio, enum TxPower);
 const char * radio_tx_power_val(enum Radio, enum TxPower);
 
+s8 mapstrcasecmp(const char *s1, const char *s2);
 u8 CONFIG_ReadModel(u8 model_num);
 u8 CONFIG_WriteModel(u8 model_num);
 u8 CONFIG_GetCurrentModel();
@@ -92,4 +93,20 @@ u8 CONFIG_ReadTemplateByIndex(u8 template_num);
 u8 CONFIG_ReadTemplate(const char *filename);
 u8 CONFIG_ReadLayout(const char *filename);
 
+#if MODEL_CATALOG_SIZE
+/* What the model list shows for models/modelN.ini, see config/model.c */
+struct ModelCatalogEntry {
+    u32 ini_crc;        // of the ini file the entry was taken from
+    char name[24];
+    char icon[13];      // file within modelico/, empty for the type's default
+    u8 type;
+    u8 protocol;
+    u8 checked;         // known to match the ini file
+};
+int CONFIG_ModelCount();
+const struct ModelCatalogEntry *CONFIG_GetModelCatalog(u8 model_num);
+void CONFIG_ModelCatalogFlush();
+void CONFIG_ModelCatalogReset();
+#endif
+
 #endif /*_MODEL_H_*/
@@ -26,6 +26,7 @@
 
 struct Transmitter Transmitter;
 static u32 crc32;
+volatile u16 config_generation;
 
 const char CURRENT_MODEL[] = "current_model";
 
@@ -57,6 +58,9 @@ const char SECTION_CALIBRATE[] = "calibrate";
 const char CALIBRATE_MAX[] = "max";
 const char CALIBRATE_MIN[] = "min";
 const char CALIBRATE_ZERO[] = "zero";
+const char CALIBRATE_FILTER[] = "filter";
+static const char * const CALIBRATE_FILTER_VAL[ADC_FILTER_LAST] = {
+    "none", "iir2", "iir4", "iir8", "median3", "median5" };
 
 const char SECTION_TOUCH[] = "touch";
 const char TOUCH_XSCALE[] = "xscale";
@@ -185,6 +189,16 @@ static int ini_handler(void* user, const char* section, const char* name, const
             t->calibration[idx].zero = value_int;
             return 1;
         }
+        if (MATCH_KEY(CALIBRATE_FILTER)) {
+            for (int i = 0; i < ADC_FILTER_LAST; i++) {
+                if (strcasecmp(CALIBRATE_FILTER_VAL[i], value) == 0) {
+                    t->calibration[idx].filter = i;
+                    return 1;
+                }
+            }
+            printf("%s: Unknown filter '%s'\n", section, value);
+            return 1;
+        }
     }
     if (HAS_TOUCH) {
         if (MATCH_SECTION(SECTION_TOUCH)) {
@@ -286,6 +300,8 @@ void CONFIG_WriteTx()
         fprintf(fh, "  %s=%d\n", CALIBRATE_MAX, t->calibration[i].max);
         fprintf(fh, "  %s=%d\n", CALIBRATE_MIN, t->calibration[i].min);
         fprintf(fh, "  %s=%d\n", CALIBRATE_ZERO, t->calibration[i].zero);
+        if (t->calibration[i].filter)
+            fprintf(fh, "  %s=%s\n", CALIBRATE_FILTER, CALIBRATE_FILTER_VAL[t->calibration[i].filter]);
     }
     if (HAS_TOUCH) {
         fprintf(fh, "[%s]\n", SECTION_TOUCH);
@@ -348,6 +364,7 @@ void CONFIG_LoadTx()
     MCU_InitModules();
     CONFIG_LoadHardware();
     CONFIG_IniParse("tx.ini", ini_handler, (void *)&Transmitter);
+    CHAN_UpdateCalibration();
     crc32 = Crc(&Transmitter, sizeof(Transmitter));
 #if HAS_EXTENDED_AUDIO
     CONFIG_VoiceParse(MAX_VOICEMAP_ENTRIES);
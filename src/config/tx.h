@@ -19,10 +19,21 @@ enum {
     CC2500_REVERSE_GD02 = 0x01,
 };
 
+enum AdcFilter {
+    ADC_FILTER_NONE,
+    ADC_FILTER_IIR2,     // first order IIR, each new sample moves the value 1/2 of the way
+    ADC_FILTER_IIR4,
+    ADC_FILTER_IIR8,
+    ADC_FILTER_MEDIAN3,  // median of the last 3 samples
+    ADC_FILTER_MEDIAN5,
+    ADC_FILTER_LAST,
+};
+
 struct StickCalibration {
     u16 max;
     u16 min;
     u16 zero;
+    u8 filter;  // enum AdcFilter, applied after oversampling
 };
 
 struct TouchCalibration {
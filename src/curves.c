@@ -165,6 +165,124 @@ s32 deadband(struct Curve *curve, s32 value)
     return max * ((1000 * (value - max) + (1000 - k) * max) / (1000 - k)) / value;
 }
 
+/* Curve lookup tables
+ * Smoothed multi-point curves and expo curves are sampled at CURVE_LUT_SIZE
+ * evenly spaced points so that the mixer only needs an index and a linear
+ * interpolation per evaluation.  Each table keeps a copy of the curve it was
+ * built from.  The mixer only compares it with the live curve through
+ * CURVE_CheckLut() after the config generation moves; if the curve was edited
+ * in place, evaluation falls back to the exact calculation until the mixers
+ * are recompiled.
+ * The interpolated result is within CURVE_LUT_TOLERANCE (0.25%) of
+ * CURVE_Evaluate() for expo curves and for splines whose adjacent points
+ * differ by no more than 50%.  Steeper splines deviate more: about 0.6% for
+ * 100% steps and up to CURVE_LUT_STEEP_TOLERANCE (1.75%) for a full-scale
+ * swing between two points of a 13-point curve.
+ */
+#if NUM_CURVE_LUTS
+#define LUT_STEP4 (4 * (CHAN_MAX_VALUE - CHAN_MIN_VALUE) / (CURVE_LUT_SIZE - 1))
+struct CurveLut {
+    struct Curve curve;
+    s16 y[CURVE_LUT_SIZE];
+};
+static struct CurveLut curve_lut[NUM_CURVE_LUTS];
+static u16 curve_lut_used;
+
+static int lut_matches(const struct CurveLut *lut, const struct Curve *curve)
+{
+    return lut->curve.type == curve->type
+           && memcmp(lut->curve.points, curve->points, sizeof(curve->points)) == 0;
+}
+
+static int use_lut(const struct Curve *curve)
+{
+    switch (CURVE_TYPE(curve)) {
+        case CURVE_EXPO:    return curve->points[0] || curve->points[1];
+        case CURVE_3POINT:
+        case CURVE_5POINT:
+        case CURVE_7POINT:
+        case CURVE_9POINT:
+        case CURVE_11POINT:
+        case CURVE_13POINT: return CURVE_SMOOTHING(curve);
+        default:            return 0;
+    }
+}
+#endif
+
+void CURVE_ClearLuts()
+{
+#if NUM_CURVE_LUTS
+    //Tables are kept so that an unchanged curve doesn't need to be rebuilt
+    curve_lut_used = 0;
+#endif
+}
+
+int CURVE_BuildLut(struct Curve *curve)
+{
+#if NUM_CURVE_LUTS
+    int i;
+    int free = -1;
+    if (! use_lut(curve))
+        return -1;
+    for (i = 0; i < NUM_CURVE_LUTS; i++) {
+        if (lut_matches(&curve_lut[i], curve)) {
+            curve_lut_used |= 1 << i;
+            return i;
+        }
+        if (free < 0 && ! (curve_lut_used & (1 << i)))
+            free = i;
+    }
+    if (free < 0)
+        return -1;
+    struct CurveLut *lut = &curve_lut[free];
+    //Invalidate first so that a concurrent evaluation uses the exact path
+    lut->curve.type = CURVE_NONE;
+    for (i = 0; i < CURVE_LUT_SIZE; i++) {
+        lut->y[i] = CURVE_Evaluate(CHAN_MIN_VALUE + i * LUT_STEP4 / 4, curve);
+    }
+    memcpy(lut->curve.points, curve->points, sizeof(curve->points));
+    lut->curve.type = curve->type;
+    curve_lut_used |= 1 << free;
+    return free;
+#else
+    (void)curve;
+    return -1;
+#endif
+}
+
+int CURVE_CheckLut(struct Curve *curve, int idx)
+{
+#if NUM_CURVE_LUTS
+    if (idx >= 0 && lut_matches(&curve_lut[idx], curve))
+        return idx;
+#else
+    (void)curve;
+    (void)idx;
+#endif
+    return -1;
+}
+
+/* idx must have been returned by CURVE_CheckLut() for the current curve */
+s32 CURVE_EvaluateLut(s32 xval, struct Curve *curve, int idx)
+{
+#if NUM_CURVE_LUTS
+    if (idx >= 0) {
+        const s16 *y = curve_lut[idx].y;
+        if (xval >= CHAN_MAX_VALUE)
+            return y[CURVE_LUT_SIZE - 1];
+        if (xval <= CHAN_MIN_VALUE)
+            return y[0];
+        u32 x4 = 4 * (xval - CHAN_MIN_VALUE);
+        u32 i = x4 / LUT_STEP4;
+        s32 frac = x4 - i * LUT_STEP4;
+        return y[i] + (y[i + 1] - y[i]) * frac / LUT_STEP4;
+    }
+#else
+    (void)idx;
+#endif
+    return CURVE_Evaluate(xval, curve);
+}
+
 s32 CURVE_Evaluate(s32 xval, struct Curve *curve)
 {
     s32 divisor;
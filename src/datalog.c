@@ -22,8 +22,10 @@
 #if HAS_DATALOG
 
 // version check by utils/datalog2csv.py
-#define DATALOG_VERSION 0x04
+#define DATALOG_VERSION 0x06
 // version 4: add dsm rssi telemetry
+// version 5: records carry a sequence number and timestamp
+// version 6: header ends with the u16 sample period in ms
 
 //This is pretty crude.  need a more robust check
 #if TXID == 10
@@ -34,31 +36,71 @@ ctassert((DLOG_LAST == 121), dlog_api_changed); // DATALOG_VERSION = 0x04
 #endif
 
 #define UPDATE_DELAY 4000 //wiat 4 seconds after changing enable before sample start
-#define DATALOG_HEADER_SIZE (3 + ((7 + NUM_DATALOG) / 8))
+#define DATALOG_HEADER_SIZE (5 + ((7 + NUM_DATALOG) / 8))
+#define DATALOG_RECORD_SIZE 7  //0xff, u16 sequence, u32 timestamp in ms
 const u32 sample_rate[DLOG_RATE_LAST] = {
     [DLOG_RATE_1SEC]  =  1000,
     [DLOG_RATE_5SEC]  =  5000,
     [DLOG_RATE_10SEC] = 10000,
     [DLOG_RATE_30SEC] = 30000,
     [DLOG_RATE_1MIN]  = 60000,
+    [DLOG_RATE_50MS]  =    50,
+    [DLOG_RATE_100MS] =   100,
+    [DLOG_RATE_250MS] =   250,
 };
 
+/* Records are staged in a RAM ring and written out in DATALOG_BLOCK_SIZE
+ * chunks aligned to the file offset, so the flash sees a few large writes
+ * instead of one per value.  dlog_pos is the file offset of the first byte
+ * still in the ring.
+ * The ring is single-producer/single-consumer: samples are produced either
+ * by DATALOG_Update() (rates of 1 sec and slower) or by DATALOG_Tick() from
+ * the mixer (faster rates), never both, and only DATALOG_Update() drains it.
+ * The producer publishes ring_head once a record is complete, and the
+ * consumer advances ring_tail once the data is on file */
+#define DATALOG_BLOCK_SIZE (DATALOG_BUFSIZE / 2)
+/* Transmitters with a hard power switch never get to flush on shutdown, so
+ * the ring is also written out every DATALOG_FLUSH_MS */
+#define DATALOG_FLUSH_MS 5000
+ctassert(((DATALOG_BUFSIZE & (DATALOG_BUFSIZE - 1)) == 0), datalog_bufsize_not_power_of_2);
+
 static FSHANDLE DatalogFAT;
 static FILE *fh;
 static u32 next_update;
 static u32 dlog_pos;
 static u32 dlog_size;
+static u8 dlog_ring[DATALOG_BUFSIZE];
+static volatile u16 ring_head;
+static volatile u16 ring_tail;
+static u16 wr_pos;
+static u16 sequence;
+static volatile u8 sampling;
+#if HAS_HARD_POWER_OFF
+static u32 next_flush;
+#endif
+
+/* Timers, telemetry and GPS are updated by the main loop while DATALOG_Write()
+ * may run from the mixer interrupt, so DATALOG_Update() copies the logged ones
+ * into one half of snap_value and then switches DATALOG_Write() over to it.
+ * Inputs and channels belong to the mixer and are read directly */
+#define SNAP_SLOT(i)   ((i) < DLOG_INPUTS ? (i) : DLOG_INPUTS + (i) - DLOG_GPSLOC)
+#define SNAP_LONGITUDE SNAP_SLOT(DLOG_LAST)
+static s32 snap_value[2][SNAP_LONGITUDE + 1];
+static volatile u8 snap_idx;
 u8 need_header_update;
 u16 data_size;
 
 const char *DATALOG_RateString(int idx)
 {
     switch(idx) {
-        case 0: return _tr_noop("1 sec");
-        case 1: return _tr_noop("5 sec");
-        case 2: return _tr_noop("10 sec");
-        case 3: return _tr_noop("30 sec");
-        case 4: return _tr_noop("60 sec");
+        case DLOG_RATE_1SEC:  return _tr_noop("1 sec");
+        case DLOG_RATE_5SEC:  return _tr_noop("5 sec");
+        case DLOG_RATE_10SEC: return _tr_noop("10 sec");
+        case DLOG_RATE_30SEC: return _tr_noop("30 sec");
+        case DLOG_RATE_1MIN:  return _tr_noop("60 sec");
+        case DLOG_RATE_50MS:  return _tr_noop("50 ms");
+        case DLOG_RATE_100MS: return _tr_noop("100 ms");
+        case DLOG_RATE_250MS: return _tr_noop("250 ms");
     }
     return "";
 }
@@ -135,66 +177,116 @@ long _find_fpos() {
             fseek(fh, dlog_pos, SEEK_SET);
             continue;
         }
-        dlog_pos += DATALOG_HEADER_SIZE;
-        size = DATALOG_GetSize(data+2) + 1;
+        dlog_pos += DATALOG_HEADER_SIZE - (data[0] >= 0x06 ? 0 : 2);
+        fseek(fh, dlog_pos, SEEK_SET);
+        size = DATALOG_GetSize(data+3) + (data[0] >= 0x05 ? DATALOG_RECORD_SIZE : 1);
     }
 }
 
+static u16 _pending()
+{
+    return ring_head - ring_tail;
+}
+
+static void _flush(u16 len)
+{
+    if (len > _pending())
+        len = _pending();
+    while (len) {
+        u16 pos = ring_tail & (DATALOG_BUFSIZE - 1);
+        u16 chunk = DATALOG_BUFSIZE - pos;
+        if (chunk > len)
+            chunk = len;
+        fwrite(dlog_ring + pos, chunk, 1, fh);
+        dlog_pos += chunk;
+        ring_tail += chunk;
+        len -= chunk;
+    }
+}
+
+void DATALOG_Flush()
+{
+    if (fh)
+        _flush(_pending());
+}
+
 void _write_8(s32 data)
 {
-    u8 x[1] = {(data & 0xff)};
-    fwrite(x, 1, 1, fh);
-    dlog_pos++;
+    if ((u16)(wr_pos - ring_tail) == DATALOG_BUFSIZE) {
+        //Only the main loop gets here, DATALOG_Tick() reserves room up front
+        ring_head = wr_pos;
+        _flush(DATALOG_BLOCK_SIZE - dlog_pos % DATALOG_BLOCK_SIZE);
+    }
+    dlog_ring[wr_pos++ & (DATALOG_BUFSIZE - 1)] = data & 0xff;
 }
 void _write_16(s32 data)
 {
-    u8 x[2] = {(data & 0xff),
-               (data >> 8) & 0xff,
-              };
-    fwrite(x, 2, 1, fh);
-    dlog_pos+=2;
+    _write_8(data);
+    _write_8(data >> 8);
 }
 
 void _write_32(s32 data)
 {
-    u8 x[4] = {(data & 0xff),
-               (data >> 8) & 0xff,
-               (data >> 16) & 0xff,
-               (data >> 24) & 0xff,
-              };
-    fwrite(x, 4, 1, fh);
-    dlog_pos+=4;
+    _write_16(data);
+    _write_16(data >> 16);
 }
 
 void _write_header() {
     need_header_update = 0;
+    sequence = 0;
     _write_8(DATALOG_VERSION);
     _write_8(TXID);
     _write_8(Model.datalog.rate);
-    fwrite(Model.datalog.source, sizeof(Model.datalog.source), 1, fh);
-    dlog_pos += 3 + sizeof(Model.datalog.source);
+    for (unsigned i = 0; i < sizeof(Model.datalog.source); i++)
+        _write_8(Model.datalog.source[i]);
+    _write_16(sample_rate[Model.datalog.rate]);
 }
 
-void DATALOG_Write()
+static void _snapshot()
 {
-    _write_8(0xff);
+    s32 *val = snap_value[! snap_idx];
     for (int i = 0; i < DLOG_LAST; i++) {
+        if(i >= DLOG_INPUTS && i < DLOG_GPSLOC)
+            continue;
         if(! (Model.datalog.source[DATALOG_BYTE(i)] & (1 << DATALOG_POS(i))))
             continue;
 #if HAS_RTC
         if(i == DLOG_TIME) {
-            _write_32(RTC_GetValue());
+            val[SNAP_SLOT(i)] = RTC_GetValue();
         } else
 #endif
         if(i == DLOG_GPSTIME) {
-            _write_32(Telemetry.gps.time);
+            val[SNAP_SLOT(i)] = Telemetry.gps.time;
         } else if(i == DLOG_GPSSPEED) {
-            _write_32(Telemetry.gps.velocity);
+            val[SNAP_SLOT(i)] = Telemetry.gps.velocity;
         } else if(i == DLOG_GPSALT) {
-            _write_32(Telemetry.gps.altitude);
+            val[SNAP_SLOT(i)] = Telemetry.gps.altitude;
         } else if(i == DLOG_GPSLOC) {
-            _write_32(Telemetry.gps.latitude);
-            _write_32(Telemetry.gps.longitude);
+            val[SNAP_SLOT(i)] = Telemetry.gps.latitude;
+            val[SNAP_LONGITUDE] = Telemetry.gps.longitude;
+        } else if(i >= DLOG_TELEMETRY) {
+            val[SNAP_SLOT(i)] = TELEMETRY_GetValue(i - DLOG_TELEMETRY + 1);
+        } else {
+            val[SNAP_SLOT(i)] = TIMER_GetValue(i) / 1000; //seconds
+        }
+    }
+    snap_idx = ! snap_idx;
+}
+
+void DATALOG_Write()
+{
+    const s32 *snap = snap_value[snap_idx];
+    _write_8(0xff);
+    _write_16(sequence++);
+    _write_32(CLOCK_getms());
+    for (int i = 0; i < DLOG_LAST; i++) {
+        if(! (Model.datalog.source[DATALOG_BYTE(i)] & (1 << DATALOG_POS(i))))
+            continue;
+        if(i == DLOG_GPSLOC) {
+            _write_32(snap[SNAP_SLOT(i)]);
+            _write_32(snap[SNAP_LONGITUDE]);
+        } else if(i >= DLOG_GPSLOC) {
+            _write_32(snap[SNAP_SLOT(i)]);
         } else if(i >= DLOG_INPUTS) {
             s32 val = MIXER_GetSourceVal(i - DLOG_INPUTS + 1, APPLY_SAFETY | APPLY_SCALAR);
             val = RANGE_TO_PCT(val);
@@ -203,27 +295,74 @@ void DATALOG_Write()
             if(val < -128)
                 val = -128;
             _write_8(val);
-        } else if(i >= DLOG_TELEMETRY) {
-            _write_16(TELEMETRY_GetValue(i - DLOG_TELEMETRY + 1));
         } else {
-            _write_16(TIMER_GetValue(i) / 1000); //seconds
+            _write_16(snap[SNAP_SLOT(i)]);
         }
     }
 }
 
-void DATALOG_Update()
+static int _is_fast_rate()
 {
-    if (! fh)
+    return Model.datalog.rate >= DLOG_RATE_50MS;
+}
+
+/* Takes a sample if one is due.  From the mixer (can_flush == 0) a record
+ * that doesn't fit in the ring is dropped, which shows up as a gap in the
+ * sequence numbers */
+static void _sample(int can_flush)
+{
+    u32 time = CLOCK_getms();
+    if (sampling || (s32)(time - next_update) < 0)
         return;
-    if(MIXER_SourceAsBoolean(Model.datalog.enable) && ((int)dlog_size - ftell(fh) >= data_size)) {
-        u32 time = CLOCK_getms();
-        if(time >= next_update) {
+    sampling = 1;
+    int needed = data_size + DATALOG_RECORD_SIZE + (need_header_update ? DATALOG_HEADER_SIZE : 0);
+    if (MIXER_SourceAsBoolean(Model.datalog.enable) && DATALOG_Remaining() >= needed) {
+        u32 period = sample_rate[Model.datalog.rate];
+        next_update += period;
+        if ((s32)(time - next_update) >= 0)
+            next_update = time + period;
+        if (can_flush || DATALOG_BUFSIZE - _pending() >= needed) {
+            wr_pos = ring_head;
             if (need_header_update)
                 _write_header();
-            next_update = time + sample_rate[Model.datalog.rate];
             DATALOG_Write();
+            ring_head = wr_pos;
+        } else {
+            sequence++;
         }
     }
+    sampling = 0;
+}
+
+void DATALOG_Tick()
+{
+    if (fh && _is_fast_rate())
+        _sample(0);
+}
+
+void DATALOG_Update()
+{
+    if (! fh)
+        return;
+    if(! MIXER_SourceAsBoolean(Model.datalog.enable)) {
+        DATALOG_Flush();
+        return;
+    }
+    if (_is_fast_rate() || (s32)(CLOCK_getms() - next_update) >= 0)
+        _snapshot();
+    if (! _is_fast_rate())
+        _sample(1);
+    //Only write whole blocks while logging
+    u16 block = DATALOG_BLOCK_SIZE - dlog_pos % DATALOG_BLOCK_SIZE;
+    if (_pending() >= block)
+        _flush(block);
+#if HAS_HARD_POWER_OFF
+    u32 time = CLOCK_getms();
+    if ((s32)(time - next_flush) >= 0) {
+        next_flush = time + DATALOG_FLUSH_MS;
+        DATALOG_Flush();
+    }
+#endif
 }
 
 void DATALOG_UpdateState()
@@ -236,16 +375,18 @@ void DATALOG_UpdateState()
 void DATALOG_Reset()
 {
     if (fh) {
+        //Holds off DATALOG_Tick() while the log is emptied
+        DATALOG_UpdateState();
         fempty(fh);
         dlog_pos = 0;
-        DATALOG_UpdateState();
+        ring_tail = ring_head;
     }
 }
 
 int DATALOG_Remaining()
 {
     if(fh)
-       return dlog_size - ftell(fh);
+       return dlog_size - dlog_pos - _pending();
     return 0;
 }
 
@@ -266,4 +407,6 @@ void DATALOG_Init()
         next_update = CLOCK_getms();
     }
 } 
+#define TESTNAME datalog
+#include <tests.h>
 #endif //HAS_DATALOG
@@ -23,6 +23,10 @@ enum {
     DLOG_RATE_10SEC,
     DLOG_RATE_30SEC,
     DLOG_RATE_1MIN,
+    //Sampled from the mixer, appended to keep existing indices
+    DLOG_RATE_50MS,
+    DLOG_RATE_100MS,
+    DLOG_RATE_250MS,
     DLOG_RATE_LAST,
 };
 
@@ -43,6 +47,8 @@ struct datalog {
 
 extern void DATALOG_Init();
 extern void DATALOG_Update();
+extern void DATALOG_Flush();
+extern void DATALOG_Tick();
 extern const char *DATALOG_Source(char *str, int idx);
 extern int DATALOG_Remaining();
 extern void DATALOG_Reset();
@@ -0,0 +1,9 @@
+﻿Español
+:4Ch w/ Dual-Rates
+4Ch con DualRate
+:6Ch Airplane
+Avión 6Ch
+:6Ch Helicopter
+Helicóptero 6Ch
+:Simple 4 Channel
+4Ch. Simple
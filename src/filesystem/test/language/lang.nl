@@ -0,0 +1,9 @@
+﻿Nederlands
+:4Ch w/ Dual-Rates
+4-kan. met Dual-Rates
+:6Ch Airplane
+6-kan. vliegtuig
+:6Ch Helicopter
+6-kan. helikopter
+:Simple 4 Channel
+Eenvoudig 4 kanalen
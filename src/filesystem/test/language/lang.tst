@@ -0,0 +1,5 @@
+Test
+:test
+abcd
+:ok
+ko
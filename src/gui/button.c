@@ -160,6 +160,7 @@ int GUI_TouchButton(struct guiObject *obj, int press_type)
         if(button->CallBack) {
             button->CallBack(objTOUCHED, button->cb_data);
             //The object may have been destroyed by now, the obj may be invalid
+            CONFIG_MarkChanged();
         }
     }
     return 1;
@@ -123,6 +123,7 @@ void GUI_HandleInput(int source, int value) {
         guiTextSelect_t *select = (guiTextSelect_t *)objSELECTED;
         if (select->InputValueCB) {
             select->InputValueCB(objSELECTED, source, value, select->cb_data);
+            CONFIG_MarkChanged();
             OBJ_SET_DIRTY(objSELECTED, 1);
         }
     }
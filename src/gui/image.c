@@ -78,6 +78,7 @@ u8 GUI_TouchImage(struct guiObject *obj, struct touch *coords, s8 press_type)
     (void)coords;
     struct guiImage *image = (struct guiImage *)obj;
     image->callback(obj, press_type, image->cb_data);
+    CONFIG_MarkChanged();
     return 1;
 }
 
@@ -275,8 +275,10 @@ u8 GUI_TouchKeyboard(struct guiObject *obj, struct touch *coords, s8 press_type)
         //Key Release
         if (keyboard->lastchar == '\x06') { //DONE
             keyboard->lastchar = '\0';
-            if (keyboard->CallBack)
+            if (keyboard->CallBack) {
                 keyboard->CallBack(obj, keyboard->cb_data);
+                CONFIG_MarkChanged();
+            }
             //After DONE it is possible that obj and keyboard are invalid
             return 1;
         } else if (keyboard->lastchar == '\x09') { //CAPS
@@ -379,6 +381,7 @@ static unsigned press_cb(u32 button, unsigned flags, void *data)
                 }
                 BUTTON_UnregisterCallback(&keyboard->action);
                 keyboard->CallBack(obj, keyboard->cb_data );
+                CONFIG_MarkChanged();
             }
             //After DONE it is possible that obj and keyboard are invalid
         } else if (CHAN_ButtonIsPressed(button, BUT_RIGHT)) {
@@ -405,6 +408,7 @@ static unsigned press_cb(u32 button, unsigned flags, void *data)
                     }
                     BUTTON_UnregisterCallback(&keyboard->action);
                     keyboard->CallBack(obj, keyboard->cb_data );
+                    CONFIG_MarkChanged();
                 }
                 //After DONE it is possible that obj and keyboard are invalid
             } else {
@@ -81,6 +81,7 @@ u8 GUI_TouchLabel(struct guiObject *obj, struct touch *coords, s8 press_type)
     (void)coords;
     struct guiLabel *label = (struct guiLabel *)obj;
     label->pressCallback(obj, press_type, label->cb_data);
+    CONFIG_MarkChanged();
     return 1;
 }
 void GUI_SetLabelDesc(struct guiLabel *label, struct LabelDesc *desc)
@@ -185,16 +185,19 @@ u8 GUI_TouchTextSelect(struct guiObject *obj, struct touch *coords, s8 press_typ
             select->state = 0;
             OBJ_SET_DIRTY(obj, 1);
             select->ValueCB(obj, -1, select->cb_data);
+            CONFIG_MarkChanged();
             return 1;
         } else if(select->state == 0x02) {
             select->state = 0;
             OBJ_SET_DIRTY(obj, 1);
             select->ValueCB(obj, 1, select->cb_data);
+            CONFIG_MarkChanged();
             return 1;
         } else if(select->state == 0x04) {
             select->state = 0;
             OBJ_SET_DIRTY(obj, 1);
             select->SelectCB(obj, select->cb_data);
+            CONFIG_MarkChanged();
             return 1;
         }
         printf("Error: Should not get here\n");
@@ -219,6 +222,7 @@ u8 GUI_TouchTextSelect(struct guiObject *obj, struct touch *coords, s8 press_typ
             } else if (select->ValueCB) {
                 OBJ_SET_DIRTY(obj, 1);
                 select->ValueCB(obj, -2, select->cb_data);
+                CONFIG_MarkChanged();
                 select->state |= 0x80;
             }
             return 1;
@@ -239,6 +243,7 @@ u8 GUI_TouchTextSelect(struct guiObject *obj, struct touch *coords, s8 press_typ
             } else if (select->ValueCB) {
                 OBJ_SET_DIRTY(obj, 1);
                 select->ValueCB(obj, 2, select->cb_data);
+                CONFIG_MarkChanged();
                 select->state |= 0x80;
             }
             return 1;
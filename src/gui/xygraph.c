@@ -151,6 +151,7 @@ u8 GUI_TouchXYGraph(struct guiObject *obj, struct touch *coords, u8 long_press)
             * (1 + graph->max_y - graph->min_y) / obj->box.height + graph->min_y;
         if(graph->touch_cb(x, y, graph->cb_data)) {
             OBJ_SET_DIRTY(obj, 1);
+            CONFIG_MarkChanged();
             return 1;
         }
     }
@@ -132,53 +132,55 @@ static void get_input_str(int src, const char **ptr, int *idx)
     #undef CHANDEF
 }
 
-static const char *_get_source_name(char *str, unsigned src, int switchname, int ignore_rename)
+static const char *_get_source_name(char *str, unsigned src, int switchname, int ignore_rename, int translate)
 {
+    #define TR(x) (translate ? _tr(x) : (x))
     unsigned is_neg = MIXER_SRC_IS_INV(src);
     src = MIXER_SRC(src);
 
     if(! src) {
-        strcpy(str, _tr("None"));
+        strcpy(str, TR("None"));
     } else if(src <= NUM_TX_INPUTS) {
         const char *ptr;
         int idx;
         get_input_str(src, &ptr, &idx);
         if(idx >= 0 && switchname)
-            sprintf(str, "%s%s%d", is_neg ? "!" : "", _tr(ptr), idx);
+            sprintf(str, "%s%s%d", is_neg ? "!" : "", TR(ptr), idx);
         else
-            sprintf(str, "%s%s", is_neg ? "!" : "", _tr(ptr));
+            sprintf(str, "%s%s", is_neg ? "!" : "", TR(ptr));
     } else if(src <= NUM_INPUTS + NUM_OUT_CHANNELS) {
-        sprintf(str, "%s%s%d", is_neg ? "!" : "", _tr("Ch"), src - NUM_INPUTS);
+        sprintf(str, "%s%s%d", is_neg ? "!" : "", TR("Ch"), src - NUM_INPUTS);
     } else if(src <= NUM_INPUTS + NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS) {
         int virt = src - NUM_INPUTS - NUM_OUT_CHANNELS;
         if (! ignore_rename && Model.virtname[virt-1][0]) {
             sprintf(str, "%s%s", is_neg ? "!" : "", Model.virtname[virt-1]);
         } else {
-            sprintf(str, "%s%s%d", is_neg ? "!" : "", _tr("Virt"), src - NUM_INPUTS - NUM_OUT_CHANNELS);
+            sprintf(str, "%s%s%d", is_neg ? "!" : "", TR("Virt"), src - NUM_INPUTS - NUM_OUT_CHANNELS);
         }
     } else {
-        sprintf(str, "%s%s%d", is_neg ? "!" : "", _tr("PPM"), src - NUM_INPUTS - NUM_OUT_CHANNELS - NUM_VIRT_CHANNELS);
+        sprintf(str, "%s%s%d", is_neg ? "!" : "", TR("PPM"), src - NUM_INPUTS - NUM_OUT_CHANNELS - NUM_VIRT_CHANNELS);
     }
+    #undef TR
     return str;
 }
 const char *INPUT_SourceName(char *str, unsigned src)
 {
-    return _get_source_name(str, src, 1, 0);
+    return _get_source_name(str, src, 1, 0, 1);
 }
 const char *INPUT_SourceNameReal(char *str, unsigned src)
 {
     // Use 'Virt' instead of renamed value
-    return _get_source_name(str, src, 1, 1);
+    return _get_source_name(str, src, 1, 1, 1);
 }
 const char *INPUT_SourceNameAbbrevSwitch(char *str, unsigned src)
 {
-    _get_source_name(str, src, 0, 0);
+    _get_source_name(str, src, 0, 0, 1);
     return str;
 }
 const char *INPUT_SourceNameAbbrevSwitchReal(char *str, unsigned src)
 {
     // Use 'Virt' instead of renamed value
-    _get_source_name(str, src, 0, 1);
+    _get_source_name(str, src, 0, 1, 1);
     return str;
 }
 
@@ -260,6 +262,129 @@ const char *INPUT_ButtonName(unsigned button)
     return "";
 }
 
+/* Name index used by the config parsers
+ * Every source, switch group, stick, legacy alias and button name is hashed
+ * once into a table sorted by hash, so a name resolves with a binary search
+ * instead of formatting and comparing every name in turn.  Names are indexed
+ * untranslated since the config files are written with translation disabled.
+ * The hash folds case and ' '/'_' like mapstrcasecmp(), and a hit is always
+ * confirmed with mapstrcasecmp(), so hash collisions are harmless.
+ */
+#define CHANMAP(oldname, new) + 1
+enum {
+    NUM_SOURCE_ALIASES = 0
+    #include "capabilities.h"
+};
+#undef CHANMAP
+// Every switch has at least 2 positions
+#define NUM_NAME_ENTRIES (NUM_SOURCES + 1 + NUM_TX_INPUTS / 2 + 4 + NUM_SOURCE_ALIASES + NUM_TX_BUTTONS + 1)
+ctassert((NUM_NAME_ENTRIES < 256), too_many_names);
+
+static struct name_entry {
+    u16 hash;
+    u8 type;
+    u8 value;
+} name_index[NUM_NAME_ENTRIES];
+static u8 name_index_len;
+
+static u16 name_hash(const char *str)
+{
+    u16 hash = 0;
+    for (; *str; str++) {
+        char c = *str;
+        if (c >= 'a')
+            c -= 'a' - 'A';
+        else if (c == ' ')
+            c = '_';
+        hash = hash * 31 + (u8)c;
+    }
+    return hash;
+}
+
+static const char *name_index_str(char *str, unsigned type, unsigned value)
+{
+    unsigned val;
+    switch(type) {
+        case INPUT_NAME_SOURCE: return _get_source_name(str, value, 1, 1, 0);
+        case INPUT_NAME_SWITCH: return _get_source_name(str, value, 0, 1, 0);
+        case INPUT_NAME_STICK:  return tx_stick_names[value - 1];
+        case INPUT_NAME_ALIAS:  return INPUT_MapSourceName(value, &val);
+        default:                return INPUT_ButtonName(value);
+    }
+}
+
+static void name_index_add(unsigned type, unsigned value)
+{
+    char str[20];
+    struct name_entry e;
+    int i;
+    if (name_index_len == NUM_NAME_ENTRIES)
+        return;
+    e.hash = name_hash(name_index_str(str, type, value));
+    e.type = type;
+    e.value = value;
+    //Keep sorted by hash, then type and value so ties resolve in search order
+    for (i = name_index_len; i > 0; i--) {
+        struct name_entry *p = &name_index[i - 1];
+        if (p->hash < e.hash || (p->hash == e.hash && p->type <= e.type))
+            break;
+        name_index[i] = *p;
+    }
+    name_index[i] = e;
+    name_index_len++;
+}
+
+static void build_name_index()
+{
+    unsigned i, val;
+    for (i = 0; i <= NUM_SOURCES; i++) {
+        name_index_add(INPUT_NAME_SOURCE, i);
+        if (i <= NUM_TX_INPUTS && INPUT_SwitchPos(i) == 0)
+            name_index_add(INPUT_NAME_SWITCH, i);
+    }
+    for (i = 1; i <= 4; i++)
+        name_index_add(INPUT_NAME_STICK, i);
+    for (i = 0; INPUT_MapSourceName(i, &val); i++)
+        name_index_add(INPUT_NAME_ALIAS, i);
+    for (i = 0; i <= NUM_TX_BUTTONS; i++)
+        name_index_add(INPUT_NAME_BUTTON, i);
+}
+
+/* Returns the source (or button) number named by 'name' considering only the
+ * INPUT_NAME_* types set in 'types', or -1 if there is no match.  Switch
+ * group names resolve to the first position of the group */
+int INPUT_FindName(const char *name, unsigned types)
+{
+    char str[20];
+    unsigned val;
+    int lo = 0, hi;
+    u16 hash = name_hash(name);
+
+    if (! name_index_len)
+        build_name_index();
+    hi = name_index_len;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (name_index[mid].hash < hash)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    for (; lo < name_index_len && name_index[lo].hash == hash; lo++) {
+        struct name_entry *e = &name_index[lo];
+        if (! (e->type & types))
+            continue;
+        if (mapstrcasecmp(name_index_str(str, e->type, e->value), name) != 0)
+            continue;
+        if (e->type == INPUT_NAME_ALIAS) {
+            INPUT_MapSourceName(e->value, &val);
+            return val;
+        }
+        return e->value;
+    }
+    return -1;
+}
+
 int INPUT_SelectInput(int src, int new_source, u8 *changed) {
     u8 is_neg = MIXER_SRC_IS_INV(src);
     if (changed) *changed = MIXER_SRC(src) == new_source ? 0 : 1;
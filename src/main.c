@@ -56,10 +56,16 @@ int main() {
     u32 buttons = ScanButtons();
     if (CHAN_ButtonIsPressed(buttons, BUT_ENTER) || !FS_Init()) {
         LCD_DrawUSBLogo(LCD_WIDTH, LCD_HEIGHT);
+#if MODEL_CATALOG_SIZE
+        // The PC may edit the models.  Holding Enter skipped the mount
+        if (FS_Init())
+            CONFIG_ModelCatalogReset();
+#endif
         USB_Connect();
     }
 
     CONFIG_LoadTx();
+    MUSIC_LoadSounds();
     SPI_ProtoInit();
     CONFIG_ReadDisplay();
     CONFIG_ReadModel(CONFIG_GetCurrentModel());
@@ -222,7 +228,13 @@ void EventLoop()
         if(! (BATTERY_Check() & BATTERY_CRITICAL)) {
             PAGE_Test();
             CONFIG_SaveModelIfNeeded();
+#if HAS_DATALOG
+            DATALOG_Flush();
+#endif
             CONFIG_SaveTxIfNeeded();
+#if STORAGE_CACHE_LINES
+            STORAGE_CacheFlush();
+#endif
         }
     	if(Transmitter.music_shutdown) {
 #if HAS_EXTENDED_AUDIO
@@ -252,13 +264,17 @@ void EventLoop()
     BUTTON_Handler();
     TOUCH_Handler();
     INPUT_CheckChanges();
+    PROTOCOL_ProcessTelemetry();
+    TELEMETRY_Alarm();
 
     if (priority_ready & (1 << LOW_PRIORITY)) {
         priority_ready  &= ~(1 << LOW_PRIORITY);
         PAGE_Event();
         PROTOCOL_CheckDialogs();
         TIMER_Update();
-        TELEMETRY_Alarm();
+#if TELEM_HISTORY_SLOTS
+        TELEMETRY_HistoryUpdate();
+#endif
         BATTERY_Check();
         AUTODIMMER_Update();
 #if HAS_DATALOG
@@ -271,10 +287,20 @@ void EventLoop()
         AUDIO_CheckQueue();
 #endif
         GUI_RefreshScreen();
+#ifdef fs_background
+        fs_background();
+#endif
 #if HAS_HARD_POWER_OFF
-        if (PAGE_ModelDoneEditing())
-            CONFIG_SaveModelIfNeeded();
-        CONFIG_SaveTxIfNeeded();
+        // Only CRC the config after something has marked it changed
+        static u16 checked_generation;
+        if (checked_generation != config_generation) {
+            u16 generation = config_generation;
+            if (PAGE_ModelDoneEditing()) {
+                CONFIG_SaveModelIfNeeded();
+                checked_generation = generation;
+            }
+            CONFIG_SaveTxIfNeeded();
+        }
 #endif
     }
 #ifdef TIMING_DEBUG
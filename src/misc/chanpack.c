@@ -0,0 +1,100 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "common.h"
+#include "mixer.h"
+#include "config/model.h"
+#include "chanpack.h"
+
+void CHANPACK_InitScale(struct ChanScale *scale, s32 origin, s32 base, s32 range, s32 div)
+{
+    u32 mag = range < 0 ? -range : range;
+    scale->origin = origin;
+    scale->base = base;
+    scale->min = INT32_MIN;
+    scale->max = INT32_MAX;
+    scale->whole = mag / div;
+    // Rounding up makes floor(x * frac / 2^32) == floor(x * rem / div) for x < 2^32 / div
+    scale->frac = (((u64)(mag % div) << 32) + div - 1) / div;
+    scale->negate = range < 0;
+}
+
+// Same mapping as the protocols' scale_channel(): clamp to +/-100% and map onto dest_min..dest_max
+void CHANPACK_InitRange(struct ChanScale *scale, s32 dest_min, s32 dest_max)
+{
+    CHANPACK_InitScale(scale, CHAN_MIN_VALUE, dest_min, dest_max - dest_min, CHAN_MAX_VALUE - CHAN_MIN_VALUE);
+    scale->min = CHAN_MIN_VALUE;
+    scale->max = CHAN_MAX_VALUE;
+}
+
+struct bitwriter {
+    u8 *dest;
+    u32 acc;
+    int nbits;
+    int bits;
+    enum ChanPackOrder order;
+};
+
+static void put_bits(struct bitwriter *w, u32 value)
+{
+    value &= (1 << w->bits) - 1;
+    if (w->order == CHANPACK_LSB_FIRST) {
+        w->acc |= value << w->nbits;
+        w->nbits += w->bits;
+        while (w->nbits >= 8) {
+            *w->dest++ = w->acc;
+            w->acc >>= 8;
+            w->nbits -= 8;
+        }
+    } else {
+        // Only the low nbits of acc are pending, older bits may be shifted out
+        w->acc = (w->acc << w->bits) | value;
+        w->nbits += w->bits;
+        while (w->nbits >= 8) {
+            w->nbits -= 8;
+            *w->dest++ = w->acc >> w->nbits;
+        }
+    }
+}
+
+static int flush_bits(struct bitwriter *w, u8 *start)
+{
+    if (w->nbits)
+        *w->dest++ = w->order == CHANPACK_LSB_FIRST ? w->acc : w->acc << (8 - w->nbits);
+    return w->dest - start;
+}
+
+/* Pack 'count' values of 'bits' (1-16) each into a contiguous bit stream.
+ * A partial last byte is padded with zeros.  Returns the number of bytes written */
+int CHANPACK_Pack(u8 *dest, const u16 *values, int count, int bits, enum ChanPackOrder order)
+{
+    struct bitwriter w = {dest, 0, 0, bits, order};
+    for (int i = 0; i < count; i++)
+        put_bits(&w, values[i]);
+    return flush_bits(&w, dest);
+}
+
+/* Scale and pack the first 'count' output channels.  Channels the model does
+ * not use are sent at the scaled value of 0 (center) */
+int CHANPACK_PackChannels(u8 *dest, const struct ChanScale *scale, int count, int bits, enum ChanPackOrder order)
+{
+    struct bitwriter w = {dest, 0, 0, bits, order};
+    for (int i = 0; i < count; i++)
+        put_bits(&w, CHANPACK_Scale(scale, i < Model.num_channels ? Channels[i] : 0));
+    return flush_bits(&w, dest);
+}
+
+#define TESTNAME chanpack
+#include <tests.h>
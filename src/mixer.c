@@ -65,6 +65,54 @@ static u32 prev_calcchannels_ms;
 
 static void MIXER_CreateCyclicOutput(volatile s32 *raw, s32 *cyclic);
 
+// A compiled mixer is a 'struct Mixer' with the bit-fields decoded and the
+// trim lookup resolved.  The curve, scalar and offset are still read through
+// 'mixer' so that in-place edits from the GUI take effect immediately
+#define MIXOP_SRC_INV  0x01
+#define MIXOP_SW_INV   0x02
+#define MIXOP_CURVE    0x04
+struct MixerOp {
+    struct Mixer *mixer;
+    u8 src;
+    u8 sw;
+    u8 dest;
+    u8 mux;
+    s8 trim;
+    s8 curve_lut;
+    u8 flags;
+};
+static struct MixerOp mixer_program[NUM_MIXERS];
+static unsigned mixer_program_len;
+
+// A chain is the run of consecutive ops that write the same destination.
+// Chains whose result depends on anything other than their inputs (MUX_DELAY,
+// or mixing into the previous value of the channel) are always evaluated
+struct MixerChain {
+    u8 first;
+    u8 count;
+    u8 always;
+};
+static struct MixerChain mixer_chain[NUM_MIXERS];
+static unsigned mixer_chain_len;
+static s8 output_trim[NUM_OUT_CHANNELS];
+
+// Sources that changed since the previous MIXER_CalcChannels() tick.  In-place
+// edits from the GUI (curves, scalars, limits) aren't tracked per source, so
+// everything is re-evaluated after each recompile and whenever
+// config_generation has moved
+static u32 dirty_src[(NUM_SOURCES + 1 + 31) / 32];
+static u16 dirty_trims;
+static s32 trim_value[NUM_TRIMS];
+static u8 full_refresh;
+static u16 mixer_generation;
+
+#define IS_DIRTY(idx)   (dirty_src[(idx) / 32] & (1UL << ((idx) % 32)))
+#define MARK_DIRTY(idx) (dirty_src[(idx) / 32] |= (1UL << ((idx) % 32)))
+
+static int find_trim(unsigned src);
+static void compile_mixer(struct MixerOp *op, struct Mixer *mixer);
+static void apply_mixer_op(const struct MixerOp *op, volatile s32 *raw, s32 *orig_value);
+
 struct Mixer *MIXER_GetAllMixers()
 {
     return Model.mixers;
@@ -96,6 +144,119 @@ void MIXER_EvalMixers(volatile s32 *raw)
 
 }
 
+/* Lower Model.mixers into mixer_program.  Must be called whenever the mixer
+ * list, the trim sources or the stick mode change.  Model.mixers is expected
+ * to already be in dependency order (see fix_mixer_dependencies) */
+void MIXER_CompileMixers()
+{
+    unsigned i, j;
+    CURVE_ClearLuts();
+    mixer_chain_len = 0;
+    for (i = 0; i < NUM_MIXERS; i++) {
+        struct MixerOp *op = &mixer_program[i];
+        if (MIXER_SRC(Model.mixers[i].src) == 0)
+            break;
+        compile_mixer(op, &Model.mixers[i]);
+        op->curve_lut = CURVE_BuildLut(&Model.mixers[i].curve);
+
+        struct MixerChain *chain = mixer_chain_len ? &mixer_chain[mixer_chain_len - 1] : NULL;
+        if (! chain || mixer_program[chain->first].dest != op->dest) {
+            chain = &mixer_chain[mixer_chain_len++];
+            chain->first = i;
+            chain->count = 0;
+            //Only a chain starting with an unconditional replace ignores the previous value
+            chain->always = op->mux != MUX_REPLACE || op->sw;
+        }
+        chain->count++;
+        if (op->mux == MUX_DELAY)
+            chain->always = 1;
+    }
+    mixer_program_len = i;
+    //A destination split over several chains can't skip any of them
+    for (i = 0; i < mixer_chain_len; i++) {
+        for (j = i + 1; j < mixer_chain_len; j++) {
+            if (mixer_program[mixer_chain[i].first].dest == mixer_program[mixer_chain[j].first].dest)
+                mixer_chain[i].always = mixer_chain[j].always = 1;
+        }
+    }
+    for (i = 0; i < NUM_OUT_CHANNELS; i++)
+        output_trim[i] = find_trim(NUM_INPUTS + 1 + i);
+    full_refresh = 1;
+}
+
+static unsigned chain_is_dirty(const struct MixerOp *op, const struct MixerOp *end)
+{
+    for (; op < end; op++) {
+        if (IS_DIRTY(op->src) || IS_DIRTY(op->sw)
+            || (op->trim >= 0 && (dirty_trims & (1 << op->trim))))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void check_curve_luts()
+{
+    for (unsigned i = 0; i < mixer_program_len; i++) {
+        struct MixerOp *op = &mixer_program[i];
+        op->curve_lut = CURVE_CheckLut(&op->mixer->curve, op->curve_lut);
+    }
+}
+
+static void run_mixer_program(volatile s32 *raw, unsigned full)
+{
+    unsigned i;
+    s32 orig_value[NUM_CHANNELS];
+    for (i = 0; i < NUM_CHANNELS; i++) {
+        orig_value[i] = raw[i + NUM_INPUTS + 1];
+    }
+    for (i = 0; i < mixer_chain_len; i++) {
+        const struct MixerChain *chain = &mixer_chain[i];
+        const struct MixerOp *op = &mixer_program[chain->first];
+        const struct MixerOp *end = op + chain->count;
+        if (! full && ! chain->always && ! chain_is_dirty(op, end))
+            continue;
+        unsigned dest = op->dest + NUM_INPUTS + 1;
+        s32 prev = raw[dest];
+        for (; op < end; op++) {
+            apply_mixer_op(op, raw, &orig_value[op->dest]);
+        }
+        if (raw[dest] != prev)
+            MARK_DIRTY(dest);
+    }
+}
+
+static void update_trims()
+{
+    dirty_trims = 0;
+    for (int i = 0; i < NUM_TRIMS; i++) {
+        s32 value = MIXER_GetTrimValue(i);
+        if (value != trim_value[i]) {
+            trim_value[i] = value;
+            dirty_trims |= 1 << i;
+        }
+    }
+}
+
+static unsigned output_is_dirty(unsigned channel)
+{
+    struct Limit *limit = &Model.limits[channel];
+    return IS_DIRTY(NUM_INPUTS + 1 + channel)
+           || limit->speed
+           || IS_DIRTY(MIXER_SRC(limit->safetysw))
+           || (output_trim[channel] >= 0 && (dirty_trims & (1 << output_trim[channel])))
+           || PPMin_Mode() == PPM_IN_TRAIN1;
+}
+
+static inline void set_raw(unsigned idx, s32 value)
+{
+    if (raw[idx] != value) {
+        raw[idx] = value;
+        MARK_DIRTY(idx);
+    }
+}
+
 unsigned MIXER_MapChannel(unsigned channel)
 {
     switch(Transmitter.mode) {
@@ -147,16 +308,16 @@ static void MIXER_UpdateRawInputs()
             int ppm_channel_map = map_ppm_channels(i);
             if (ppm_channel_map >= 0) {
                 if (ppmSync) {
-                    raw[i] = ppmChannels[ppm_channel_map];
+                    set_raw(i, ppmChannels[ppm_channel_map]);
                 }
                 continue;
             }
         }
-        raw[i] = CHAN_ReadInput(mapped_channel);
+        set_raw(i, CHAN_ReadInput(mapped_channel));
     }
     if (PPMin_Mode() == PPM_IN_SOURCE && ppmSync) {
         for (i = 0; i < Model.num_ppmin_channels; i++) {
-            raw[1 + NUM_INPUTS + NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS + i] = ppmChannels[i];
+            set_raw(1 + NUM_INPUTS + NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS + i, ppmChannels[i]);
         }
     }
 }
@@ -182,10 +343,21 @@ void MIXER_CalcChannels()
 
     //We retain this array so that we can refer to the prevous values in the next iteration
     int i;
+    unsigned full = full_refresh;
+    full_refresh = 0;
+    memset(dirty_src, 0, sizeof(dirty_src));
+    //The GUI may have edited the mixers or curves in place
+    u16 generation = config_generation;
+    if (mixer_generation != generation) {
+        mixer_generation = generation;
+        check_curve_luts();
+        full = 1;
+    }
     //1st step: Read Tx inputs
     MIXER_UpdateRawInputs();
+    update_trims();
     //3rd steps
-    MIXER_EvalMixers(raw);
+    run_mixer_program(raw, full);
 
     //4th step: apply auto-templates
     s32 cyclic[3];
@@ -195,14 +367,19 @@ void MIXER_CalcChannels()
             case MIXERTEMPLATE_CYC1:
             case MIXERTEMPLATE_CYC2:
             case MIXERTEMPLATE_CYC3:
-                raw[NUM_INPUTS+i+1] = cyclic[Model.templates[i] - MIXERTEMPLATE_CYC1];
+                set_raw(NUM_INPUTS+i+1, cyclic[Model.templates[i] - MIXERTEMPLATE_CYC1]);
                 break;
         }
     }
     //5th step: apply limits
     for (i = 0; i < NUM_OUT_CHANNELS; i++) {
-        Channels[i] = MIXER_GetChannel(i, APPLY_ALL);
+        if (full || output_is_dirty(i))
+            Channels[i] = MIXER_GetChannel(i, APPLY_ALL);
     }
+#if HAS_DATALOG
+    //High rate datalog samples are taken on the mixer tick
+    DATALOG_Tick();
+#endif
 }
 
 volatile s32 *MIXER_GetInputs()
@@ -296,30 +473,71 @@ void MIXER_CreateCyclicOutput(volatile s32 *raw, s32 *cyclic)
     }
 }
 
+static int find_trim(unsigned src)
+{
+    int i;
+    for (i = 0; i < NUM_TRIMS; i++) {
+        if (MIXER_MapChannel(Model.trims[i].src) == src) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void compile_mixer(struct MixerOp *op, struct Mixer *mixer)
+{
+    op->mixer = mixer;
+    op->src = MIXER_SRC(mixer->src);
+    op->sw = MIXER_SRC(mixer->sw);
+    op->dest = mixer->dest;
+    op->mux = MIXER_MUX(mixer);
+    op->trim = MIXER_APPLY_TRIM(mixer) ? find_trim(op->src) : -1;
+    op->curve_lut = -1;
+    op->flags = 0;
+    if (MIXER_SRC_IS_INV(mixer->src))
+        op->flags |= MIXOP_SRC_INV;
+    if (MIXER_SRC_IS_INV(mixer->sw))
+        op->flags |= MIXOP_SW_INV;
+    if (CURVE_TYPE(&mixer->curve) != CURVE_NONE)
+        op->flags |= MIXOP_CURVE;
+}
+
 void MIXER_ApplyMixer(struct Mixer *mixer, volatile s32 *raw, s32 *orig_value)
+{
+    struct MixerOp op;
+    compile_mixer(&op, mixer);
+    apply_mixer_op(&op, raw, orig_value);
+}
+
+static void apply_mixer_op(const struct MixerOp *op, volatile s32 *raw, s32 *orig_value)
 {
     s32 value;
-    if (! MIXER_SRC(mixer->src))
-        return;
-    if (! switch_is_on(mixer->sw, raw)) {
-        // Switch is off, so this mixer is not active
+    struct Mixer *mixer = op->mixer;
+    if (! op->src)
         return;
+    if (op->sw) {
+        value = raw[op->sw];
+        if ((op->flags & MIXOP_SW_INV) ? value >= 0 : value <= 0) {
+            // Switch is off, so this mixer is not active
+            return;
+        }
     }
     //1st: Get source value with trim
-    value = raw[MIXER_SRC(mixer->src)];
+    value = raw[op->src];
     //Invert if necessary
-    if (MIXER_SRC_IS_INV(mixer->src))
+    if (op->flags & MIXOP_SRC_INV)
         value = - value;
 
     //2nd: apply curve
-    value = CURVE_Evaluate(value, &mixer->curve);
+    if (op->flags & MIXOP_CURVE)
+        value = CURVE_EvaluateLut(value, &mixer->curve, op->curve_lut);
 
     //3rd: apply scalar and offset
     value = value * mixer->scalar / 100 + PCT_TO_RANGE(mixer->offset);
 
     //4th: multiplex result
-    s32 scaled_value = raw[mixer->dest + NUM_INPUTS + 1];
-    switch(MIXER_MUX(mixer)) {
+    s32 scaled_value = raw[op->dest + NUM_INPUTS + 1];
+    switch(op->mux) {
     case MUX_REPLACE:
         break;
     case MUX_MULTIPLY:
@@ -394,8 +612,8 @@ void MIXER_ApplyMixer(struct Mixer *mixer, volatile s32 *raw, s32 *orig_value)
     }
 
     //5th: apply trim
-    if (MIXER_APPLY_TRIM(mixer))
-        value = value + (MIXER_SRC_IS_INV(mixer->src) ? -1 : 1) * get_trim(MIXER_SRC(mixer->src));
+    if (op->trim >= 0)
+        value = value + ((op->flags & MIXOP_SRC_INV) ? -1 : 1) * MIXER_GetTrimValue(op->trim);
 
     //Ensure we don't overflow
     if (value > INT16_MAX)
@@ -403,7 +621,7 @@ void MIXER_ApplyMixer(struct Mixer *mixer, volatile s32 *raw, s32 *orig_value)
     else if (value < INT16_MIN)
         value = INT16_MIN;
 
-    raw[mixer->dest + NUM_INPUTS + 1] = value;
+    raw[op->dest + NUM_INPUTS + 1] = value;
 }
 
 s32 MIXER_ApplyLimits(unsigned channel, struct Limit *limit, volatile s32 *_raw,
@@ -486,13 +704,8 @@ s32 MIXER_GetTrimValue(int i)
 
 s32 get_trim(unsigned src)
 {
-    int i;
-    for (i = 0; i < NUM_TRIMS; i++) {
-        if (MIXER_MapChannel(Model.trims[i].src) == src) {
-            return MIXER_GetTrimValue(i);
-        }
-    }
-    return 0;
+    int i = find_trim(src);
+    return i < 0 ? 0 : MIXER_GetTrimValue(i);
 }
 
 unsigned switch_is_on(unsigned sw, volatile s32 *raw)
@@ -527,6 +740,8 @@ void MIXER_RegisterTrimButtons()
         mask |= CHAN_ButtonMask(Model.trims[i].pos);
     }
     BUTTON_RegisterCallback(&button_action, mask, BUTTON_PRESS | BUTTON_LONGPRESS | BUTTON_RELEASE, MIXER_UpdateTrim, NULL);
+    //Trim sources are resolved when the mixers are compiled
+    MIXER_CompileMixers();
 }
 enum TemplateType MIXER_GetTemplate(int ch)
 {
@@ -536,6 +751,7 @@ enum TemplateType MIXER_GetTemplate(int ch)
 void MIXER_SetTemplate(int ch, enum TemplateType value)
 {
     Model.templates[ch] = value;
+    CONFIG_MarkChanged();
 };
 
 int MIXER_GetMixers(int ch, struct Mixer *mixers, int count)
@@ -653,6 +869,7 @@ void fix_mixer_dependencies(unsigned mixer_count)
         }
     }
     MIXER_ReorderMixers(Model.mixers, order, pos);
+    MIXER_CompileMixers();
 }
 
 int MIXER_SetMixers(struct Mixer *mixers, int count)
@@ -691,6 +908,7 @@ int MIXER_SetMixers(struct Mixer *mixers, int count)
         }
     }
     fix_mixer_dependencies(pos);
+    CONFIG_MarkChanged();
     return 1;
 }
 
@@ -704,8 +922,10 @@ struct Limit *MIXER_GetLimit(int ch)
 
 void MIXER_SetLimit(int ch, struct Limit *limit)
 {
-    if (ch < NUM_OUT_CHANNELS)
+    if (ch < NUM_OUT_CHANNELS) {
         Model.limits[ch] = *limit;
+        CONFIG_MarkChanged();
+    }
 }
 
 void MIXER_InitMixer(struct Mixer *mixer, unsigned ch)
@@ -801,8 +1021,12 @@ unsigned MIXER_UpdateTrim(u32 buttons, unsigned flags, void *data)
         reach_end = 0;
         int neg_button = CHAN_ButtonIsPressed(buttons, Model.trims[i].neg);
         if (neg_button || CHAN_ButtonIsPressed(buttons, Model.trims[i].pos)) {
+            s8 *value = MIXER_GetTrim(i);
+            s8 old_value = *value;
             if (Model.trims[i].step > TRIM_MAX_VALUE) {
                 _trim_as_switch(flags, i, neg_button);
+                if (*value != old_value)
+                    CONFIG_MarkChanged();
                 continue;
             }
             if (flags & BUTTON_RELEASE)
@@ -810,7 +1034,6 @@ unsigned MIXER_UpdateTrim(u32 buttons, unsigned flags, void *data)
             int max = 100;
             if (neg_button)
                 step_size = -step_size;
-            s8 *value = MIXER_GetTrim(i);
             tmp = (int)(*value) + step_size;
             //print_buttons(buttons);
             if ((int)*value > 0 && tmp <= 0) {
@@ -828,6 +1051,8 @@ unsigned MIXER_UpdateTrim(u32 buttons, unsigned flags, void *data)
             } else {
                 *value = tmp;
             }
+            if (*value != old_value)
+                CONFIG_MarkChanged();
 
             if (reach_end && (flags & BUTTON_LONGPRESS))
                 BUTTON_InterruptLongPress();
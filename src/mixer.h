@@ -187,7 +187,14 @@ struct Trim {
 };
 
 /* Curve functions */
+#define CURVE_LUT_SIZE 129
+#define CURVE_LUT_TOLERANCE 25
+#define CURVE_LUT_STEEP_TOLERANCE 175
 s32 CURVE_Evaluate(s32 value, struct Curve *curve);
+int CURVE_CheckLut(struct Curve *curve, int lut);
+s32 CURVE_EvaluateLut(s32 value, struct Curve *curve, int lut);
+int CURVE_BuildLut(struct Curve *curve);
+void CURVE_ClearLuts();
 const char *CURVE_GetName(char *str, struct Curve *curve);
 unsigned CURVE_NumPoints(struct Curve *curve);
 
@@ -210,6 +217,7 @@ void MIXER_InitMixer(struct Mixer *mixer, unsigned ch);
 
 void MIXER_ApplyMixer(struct Mixer *mixer, volatile s32 *raw, s32 *orig_value);
 void MIXER_EvalMixers(volatile s32 *raw);
+void MIXER_CompileMixers();
 int MIXER_GetCachedInputs(s32 *raw, unsigned threshold);
 
 struct Mixer *MIXER_GetAllMixers();
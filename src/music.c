@@ -20,7 +20,12 @@
 #include "config/model.h"
 #include <stdlib.h>
 
-static struct {u8 note; u8 duration;} Notes[100];
+struct Note {
+    u8 note;
+    u8 duration;
+};
+static struct Note Notes[100];
+static const struct Note *notes;
 static u8 Volume;
 static u8 next_note;
 static u8 num_notes;
@@ -63,6 +68,24 @@ static u8 playback_device;
 #endif
 static u8 vibrate;
 
+/* sound.ini is parsed once into sound_notes[], with every section's
+ * attributes resolved, so MUSIC_Play() never touches the filesystem */
+#define SOUND_VOLUME_UNSET 0xff
+static struct Note sound_notes[SOUND_TABLE_NOTES];
+static struct Sound {
+    u8 start;
+    u8 count;
+    u8 volume;
+    u8 vibrate;
+#if HAS_EXTENDED_AUDIO
+    u8 device;
+#endif
+} sounds[MUSIC_TOTAL];
+static u8 sound_notes_used;
+static u8 sounds_loaded;
+static u8 sounds_valid;
+ctassert(SOUND_TABLE_NOTES <= 255, sound_table_too_large);
+
 #define NUM_FREQ_ONE_SCALE 12
 static const u16 freqs[] = {220, 233, 247, 262, 277, 294, 311, 330, 349, 370, 392, 415};
 
@@ -117,43 +140,88 @@ static u8 get_note(const char *value)
 
 static int ini_handler(void* user, const char* section, const char* name, const char* value)
 {
-    const char *requested_sec = (const char *)user;
-    if (strcasecmp(section, requested_sec) == 0) {
+    (void)user;
+    unsigned music;
+    for (music = 0; music < MUSIC_TOTAL; music++) {
+        if (strcasecmp(section, sections[music]) == 0)
+            break;
+    }
+    if (music == MUSIC_TOTAL)
+        return 1;
+    struct Sound *sound = &sounds[music];
+    if (! sound->count) {
+        sound->start = sound_notes_used;
+    } else if (sound->start + sound->count != sound_notes_used) {
+        printf("ERROR: Section [%s] is split in sound.ini\n", section);
+        return 1;
+    }
 #if HAS_EXTENDED_AUDIO
-        if (strcasecmp("device", name) == 0) {
-            for (u16 i = 1; i < AUDDEV_LAST; i++) {
-                if (strcasecmp(audio_devices[i], value) == 0) {
-                    playback_device = i;
-                    break;
-                }
+    if (strcasecmp("device", name) == 0) {
+        for (u16 i = 1; i < AUDDEV_LAST; i++) {
+            if (strcasecmp(audio_devices[i], value) == 0) {
+                sound->device = i;
+                break;
             }
         }
+    }
 #endif
-        if (strcasecmp("vibrate", name) == 0) {
-            if (strcasecmp(value, "off") == 0) {
-                vibrate = 0;
-            }
-        }
-        if (strcasecmp("volume", name) == 0) {
-            Volume = atoi(value);
-            if (Volume > 100)
-                Volume = 100;
-            // The music volume should be controlled by TX volume setting as well as sound.ini
-            Volume = Transmitter.volume * Volume/10; // = Transmitter.volume * 10 * sound_volume/100;
+    if (strcasecmp("vibrate", name) == 0) {
+        if (strcasecmp(value, "off") == 0) {
+            sound->vibrate = 0;
         }
-        Notes[num_notes].note = get_note(name);
-        Notes[num_notes].duration = atoi(value) / 10; //convert from msec to centi-secs
-        num_notes++;
+    }
+    if (strcasecmp("volume", name) == 0) {
+        sound->volume = atoi(value);
+        if (sound->volume > 100)
+            sound->volume = 100;
+    }
+    if (sound_notes_used == SOUND_TABLE_NOTES) {
+        printf("ERROR: sound.ini has more than %d notes\n", SOUND_TABLE_NOTES);
         return 1;
     }
+    sound_notes[sound_notes_used].note = get_note(name);
+    sound_notes[sound_notes_used].duration = atoi(value) / 10; //convert from msec to centi-secs
+    sound_notes_used++;
+    sound->count++;
     return 1;
 }
 
+void MUSIC_LoadSounds()
+{
+    #ifdef _DEVO12_TARGET_H_
+    char filename[] = "media/sound.ini\0\0\0"; // placeholder for longer folder name
+    FILE *fh;
+    fh = fopen("mymedia/sound.ini", "r");
+    if(fh) {
+        sprintf(filename, "mymedia/sound.ini");
+        fclose(fh);
+    }
+    #else
+    char filename[] = "media/sound.ini";
+    #endif
+    for (unsigned i = 0; i < MUSIC_TOTAL; i++) {
+        sounds[i].start = 0;
+        sounds[i].count = 0;
+        sounds[i].volume = SOUND_VOLUME_UNSET;
+        sounds[i].vibrate = 1;
+#if HAS_EXTENDED_AUDIO
+        sounds[i].device = AUDDEV_UNDEF;
+#endif
+    }
+    sound_notes_used = 0;
+    sounds_loaded = 1;
+    sounds_valid = 1;
+    if(CONFIG_IniParse(filename, ini_handler, NULL)) {
+        printf("ERROR: Could not read %s\n", filename);
+        sounds_valid = 0;
+    }
+}
+
 u16 next_note_cb() {
     if (next_note == num_notes)
         return 0;
-    SOUND_SetFrequency(get_freq(Notes[next_note].note), Volume);
-    return Notes[next_note++].duration * 10;
+    SOUND_SetFrequency(get_freq(notes[next_note].note), Volume);
+    return notes[next_note++].duration * 10;
 }
 
 void MUSIC_Beep(char* note, u16 duration, u16 interval, u8 count)
@@ -164,9 +232,10 @@ void MUSIC_Beep(char* note, u16 duration, u16 interval, u8 count)
     Volume = Transmitter.volume * 10;
     if(! count)
         return;
-    if(count > sizeof(Notes)/2)
-        count = sizeof(Notes)/2;
+    if(count > sizeof(Notes) / sizeof(Notes[0]) / 2)
+        count = sizeof(Notes) / sizeof(Notes[0]) / 2;
     tone = get_note(note);
+    notes = Notes;
     num_notes = count*2;
     for(i=0; i<count; i++) {
         Notes[i*2].note = tone;
@@ -182,29 +251,27 @@ u16 MUSIC_GetSound(u16 music) {
     num_notes = 0;
     next_note = 1;
     Volume = Transmitter.volume * 10;
-    #ifdef _DEVO12_TARGET_H_
-    static char filename[] = "media/sound.ini\0\0\0"; // placeholder for longer folder name
-    static u8 checked;
-        if(!checked) {
-            FILE *fh;
-            fh = fopen("mymedia/sound.ini", "r");
-            if(fh) {
-                sprintf(filename, "mymedia/sound.ini");
-                fclose(fh);
-            }
-            checked = 1;
-        }
-    #else
-    char filename[] = "media/sound.ini";
-    #endif
     if (music >= MUSIC_TOTAL) {
         printf("ERROR: Music %d can not be found in sound.ini", music);
         return 1;
     }
-    if(CONFIG_IniParse(filename, ini_handler, (void *)sections[music])) {
-        printf("ERROR: Could not read %s\n", filename);
+    if (! sounds_loaded)
+        MUSIC_LoadSounds();
+    if (! sounds_valid)
         return 1;
+    const struct Sound *sound = &sounds[music];
+#if HAS_EXTENDED_AUDIO
+    if (sound->device != AUDDEV_UNDEF)
+        playback_device = sound->device;
+#endif
+    if (! sound->vibrate)
+        vibrate = 0;
+    if (sound->volume != SOUND_VOLUME_UNSET) {
+        // The music volume should be controlled by TX volume setting as well as sound.ini
+        Volume = Transmitter.volume * sound->volume / 10; // = Transmitter.volume * 10 * sound_volume/100;
     }
+    notes = &sound_notes[sound->start];
+    num_notes = sound->count;
     return 0;
 }
 
@@ -239,8 +306,8 @@ void MUSIC_Play(u16 music)
 #endif
 
     if(! num_notes) return;
-    SOUND_SetFrequency(get_freq(Notes[next_note].note), Volume);
-    SOUND_Start((u16)Notes[0].duration * 10, next_note_cb, vibrate);
+    SOUND_SetFrequency(get_freq(notes[next_note].note), Volume);
+    SOUND_Start((u16)notes[0].duration * 10, next_note_cb, vibrate);
 }
 
 #if HAS_EXTENDED_AUDIO
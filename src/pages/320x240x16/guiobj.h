@@ -226,6 +226,9 @@ struct telemtest_obj {
    guiLabel_t msg;
    guiLabel_t label[30];
    guiLabel_t value[30];
+#if TELEM_HISTORY_SLOTS
+   guiXYGraph_t graph;
+#endif
 };
 
 struct timer_obj {
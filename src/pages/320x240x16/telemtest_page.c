@@ -149,6 +149,139 @@ static const struct telem_layout *_get_layout()
     return NULL;
 }
 
+#if TELEM_HISTORY_SLOTS
+/* Pressing a value shows its history: the last TELEM_HISTORY_SAMPLES one (or
+ * ten) second averages, and min/avg/max since telemetry was last reset.
+ * The source stays tracked after leaving the page */
+#define TREND_RANGE 100
+
+static void show_page();
+
+static int read_trend()
+{
+    s32 last = tp->trend_count ? tp->trend[tp->trend_count - 1] : 0;
+    u8 count = tp->trend_count;
+    const struct TelemetryStats *stats = TELEMETRY_HistoryStats(tp->trend_src);
+    tp->trend_samples = stats ? stats->count : 0;
+    tp->trend_count = TELEMETRY_HistoryGet(tp->trend_src, tp->trend_level, tp->trend, TELEM_HISTORY_SAMPLES);
+    tp->trend_min = tp->trend_max = tp->trend_count ? tp->trend[0] : 0;
+    for (int i = 1; i < tp->trend_count; i++) {
+        if (tp->trend[i] < tp->trend_min)
+            tp->trend_min = tp->trend[i];
+        else if (tp->trend[i] > tp->trend_max)
+            tp->trend_max = tp->trend[i];
+    }
+    return count != tp->trend_count || (tp->trend_count && last != tp->trend[tp->trend_count - 1]);
+}
+
+static s32 trend_cb(s32 xval, void *data)
+{
+    (void)data;
+    if (! tp->trend_count || tp->trend_max == tp->trend_min)
+        return TREND_RANGE / 2;
+    // Newest sample on the right
+    int idx = xval - (TELEM_HISTORY_SAMPLES - tp->trend_count);
+    if (idx < 0)
+        idx = 0;
+    return (int64_t)(tp->trend[idx] - tp->trend_min) * TREND_RANGE / (tp->trend_max - tp->trend_min);
+}
+
+static const char *trend_stats_cb(guiObject_t *obj, const void *data)
+{
+    (void)obj;
+    (void)data;
+    const struct TelemetryStats *stats = TELEMETRY_HistoryStats(tp->trend_src);
+    char *str = tempstring;
+    TELEMETRY_ShortName(str, tp->trend_src);
+    if (stats) {
+        const s32 values[] = {stats->min, stats->mean, stats->max};
+        const char *names[] = {_tr("Min"), _tr("Avg"), _tr("Max")};
+        for (int i = 0; i < 3; i++) {
+            str += strlen(str);
+            sprintf(str, "  %s ", names[i]);
+            str += strlen(str);
+            TELEMETRY_GetValueStrByValue(str, tp->trend_src, values[i]);
+        }
+    }
+    return tempstring;
+}
+
+static const char *trend_level_cb(guiObject_t *obj, const void *data)
+{
+    (void)obj;
+    (void)data;
+    return tp->trend_level == TELEM_HISTORY_1SEC ? _tr("1 second per point") : _tr("10 seconds per point");
+}
+
+static void toggle_level()
+{
+    tp->trend_level = tp->trend_level == TELEM_HISTORY_1SEC ? TELEM_HISTORY_10SEC : TELEM_HISTORY_1SEC;
+    read_trend();
+    GUI_Redraw(&gui->label[0]);
+}
+
+static u8 trend_touch_cb(s16 x, s16 y, void *data)
+{
+    (void)x;
+    (void)y;
+    (void)data;
+    toggle_level();
+    return 1;
+}
+
+static void level_press_cb(guiObject_t *obj, s8 press_type, const void *data)
+{
+    (void)obj;
+    (void)data;
+    if (press_type == -1) {
+        toggle_level();
+        GUI_Redraw(&gui->graph);
+    }
+}
+
+static void show_trend()
+{
+    GUI_RemoveAllObjects();
+    PAGE_ShowHeader(PAGE_GetName(PAGEID_TELEMMON));
+    read_trend();
+    GUI_CreateLabelBox(&gui->msg, 10 + TELEM_OFFSET_X, 40 + TELEM_OFFSET_Y, 300, 18, &LABEL_FONT,
+                       trend_stats_cb, NULL, NULL);
+    GUI_CreateXYGraph(&gui->graph, 10 + TELEM_OFFSET_X, 62 + TELEM_OFFSET_Y, 300, 150,
+                      0, 0, TELEM_HISTORY_SAMPLES - 1, TREND_RANGE, 10, 0,
+                      trend_cb, NULL, trend_touch_cb, NULL);
+    GUI_CreateLabelBox(&gui->label[0], 10 + TELEM_OFFSET_X, 218 + TELEM_OFFSET_Y, 300, 18, &NARROW_FONT,
+                       trend_level_cb, level_press_cb, NULL);
+}
+
+static void value_press_cb(guiObject_t *obj, s8 press_type, const void *data)
+{
+    (void)obj;
+    if (press_type == -1 && TELEMETRY_HistoryTrack((long)data)) {
+        tp->trend_src = (long)data;
+        tp->trend_level = TELEM_HISTORY_1SEC;
+        tp->trend_count = 0;
+        show_trend();
+    }
+}
+
+static unsigned action_cb(u32 button, unsigned flags, void *data)
+{
+    if (tp->trend_src && CHAN_ButtonIsPressed(button, BUT_EXIT)) {
+        if (flags & BUTTON_RELEASE) {
+            // Back to the monitor
+            tp->trend_src = 0;
+            GUI_RemoveAllObjects();
+            PAGE_ShowHeader(PAGE_GetName(PAGEID_TELEMMON));
+            show_page();
+        }
+        return 1;
+    }
+    return default_button_action_cb(button, flags, data);
+}
+#else
+#define value_press_cb NULL
+#endif  // TELEM_HISTORY_SLOTS
+
 static void show_page()
 {
     const struct telem_layout *layout = _get_layout();
@@ -160,7 +293,7 @@ static void show_page()
                            label_cb, NULL, (void *)(long)ptr->source);
         GUI_CreateLabelBox(&gui->value[i], ptr->value.x + TELEM_OFFSET_X, ptr->value.y + TELEM_OFFSET_Y,
                            ptr->value.width, ptr->value.height, &TELEM_ERR_FONT,
-                           telem_cb, NULL, (void *)(long)ptr->source);
+                           telem_cb, value_press_cb, (void *)(long)ptr->source);
         i++;
     }
     tp->telem = Telemetry;
@@ -178,6 +311,10 @@ void PAGE_TelemtestInit(int page)
     (void)page;
     PAGE_SetModal(0);
     PAGE_ShowHeader(PAGE_GetName(PAGEID_TELEMMON));
+#if TELEM_HISTORY_SLOTS
+    tp->trend_src = 0;
+    PAGE_SetActionCB(action_cb);
+#endif
     if (telem_state_check() == 0) {
         GUI_CreateLabelBox(&gui->msg, 20, 80, 280, 100, &NARROW_FONT, NULL, NULL, tempstring);
         return;
@@ -186,6 +323,17 @@ void PAGE_TelemtestInit(int page)
 }
 
 void PAGE_TelemtestEvent() {
+#if TELEM_HISTORY_SLOTS
+    if (tp->trend_src) {
+        const struct TelemetryStats *stats = TELEMETRY_HistoryStats(tp->trend_src);
+        if ((stats ? stats->count : 0) != tp->trend_samples) {
+            GUI_Redraw(&gui->msg);
+            if (read_trend())
+                GUI_Redraw(&gui->graph);
+        }
+        return;
+    }
+#endif
     static u32 count;
     int flicker = ((++count & 3) == 0);
     struct Telemetry cur_telem = Telemetry;
@@ -29,7 +29,10 @@ static const char *ratesel_cb(guiObject_t *obj, int dir, void *data)
 {
     (void)obj;
     (void)data;
-    dlog->rate = GUI_TextSelectHelper(dlog->rate, 0, DLOG_RATE_LAST-1, dir, 1, 1, NULL);
+    u8 changed;
+    dlog->rate = GUI_TextSelectHelper(dlog->rate, 0, DLOG_RATE_LAST-1, dir, 1, 1, &changed);
+    if (changed)
+        DATALOG_UpdateState();
     return _tr(DATALOG_RateString(dlog->rate));
 }
 
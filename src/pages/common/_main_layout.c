@@ -160,6 +160,7 @@ void move_elem()
     GUI_DrawBackground(x, y, w, h);
     ELEM_SET_X(pc->elem[idx], lp->selected_x);
     ELEM_SET_Y(pc->elem[idx], lp->selected_y);
+    CONFIG_MarkChanged();
     draw_elements();
     select_for_move((guiLabel_t *)obj);
 }
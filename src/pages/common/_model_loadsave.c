@@ -63,10 +63,20 @@ static void change_icon(int sel)
         }
     } else {
         sel++; //models are indexed from 1
-        sprintf(tempstring, "models/model%d.ini", sel);
         mp->modeltype = 0;
         mp->iconstr[0] = 0;
-        ini_parse(tempstring, ini_handle_icon, NULL);
+#if MODEL_CATALOG_SIZE
+        const struct ModelCatalogEntry *entry = CONFIG_GetModelCatalog(sel);
+        if (entry) {
+            mp->modeltype = entry->type;
+            if (entry->icon[0])
+                CONFIG_ParseIconName(mp->iconstr, entry->icon);
+        } else
+#endif
+        {
+            sprintf(tempstring, "models/model%d.ini", sel);
+            ini_parse(tempstring, ini_handle_icon, NULL);
+        }
         if (sel == CONFIG_GetCurrentModel() && Model.icon[0])
             ico = Model.icon;
         else {
@@ -101,11 +111,31 @@ int get_idx_filename(char *result, const char *dir, const char *ext, int idx, co
     FS_CloseDir();
     return 0;
 }
+#if MODEL_CATALOG_SIZE
+static const char *catalog_name(int idx, int model_num, const char *suffix)
+{
+    const struct ModelCatalogEntry *entry = CONFIG_GetModelCatalog(model_num);
+    if (! entry)
+        return NULL;
+    sprintf(tempstring, "%d: %s%s", idx + 1, entry->name[0] ? entry->name : "NONE", suffix);
+    return tempstring;
+}
+#endif
+
 static const char *name_cb(guiObject_t *obj, const void *data)
 {
     (void)obj;
     long idx = (long)data;
     FILE *fh;
+#if MODEL_CATALOG_SIZE
+    const char *str = NULL;
+    if (mp->menu_type == LOAD_LAYOUT && idx >= mp->file_state)
+        str = catalog_name(idx, idx + 1 - mp->file_state, "(M)");
+    else if (mp->menu_type == LOAD_MODEL || mp->menu_type == SAVE_MODEL)
+        str = idx + 1 == CONFIG_GetCurrentModel() ? NULL : catalog_name(idx, idx + 1, "");
+    if (str)
+        return str;
+#endif
     if (mp->menu_type == LOAD_TEMPLATE) { //Template
         if (! get_idx_filename(tempstring, "template", ".ini", idx, "template/"))
             return _tr("Unknown");
@@ -144,6 +174,9 @@ static const char *name_cb(guiObject_t *obj, const void *data)
 
 int model_count()
 {
+#if MODEL_CATALOG_SIZE
+    return CONFIG_ModelCount();
+#else
     int num_models;
     for (num_models = 1; num_models <= 255; num_models++) {
         sprintf(tempstring, "models/model%d.ini", num_models);
@@ -155,6 +188,7 @@ int model_count()
     }
     num_models--;
     return num_models;
+#endif
 }
 
 /*count will be in mp->total_items. Return is selection if any */
@@ -251,3 +285,12 @@ static int get_scroll_count(enum loadSaveType p)
         selected--;
     return selected;
 }
+
+void PAGE_LoadSaveExit()
+{
+#if MODEL_CATALOG_SIZE
+    //Entries checked while the list was drawn are written back here, not
+    //from the label callbacks
+    CONFIG_ModelCatalogFlush();
+#endif
+}
@@ -97,6 +97,7 @@ void PAGE_TrainConfigInit(int page);
 void MODELVIDEO_Config();
 void MODELPage_Template();
 void PAGE_LoadSaveInit(int page);
+void PAGE_LoadSaveExit();
 
 /* RTC */
 void PAGE_RTCInit(int page);
@@ -124,6 +124,10 @@ void PAGE_CalibInit(int page)
     GUI_CreateLabelBox(&guic->msg, 1, CALIB_Y, 0, 0,
             LCD_HEIGHT > 70? &NARROW_FONT:&DEFAULT_FONT, NULL, NULL, tempstring);
     memcpy(cp->calibration, Transmitter.calibration, sizeof(cp->calibration));
+    // Calibrate on unfiltered readings: the IIR modes lag behind the sticks
+    // and the median modes hold back the extremes
+    for (u8 i = 0; i < INP_HAS_CALIBRATION; i++)
+        Transmitter.calibration[i].filter = ADC_FILTER_NONE;
 
     while(1) {
         CLOCK_ResetWatchdog();
@@ -150,6 +154,10 @@ void PAGE_CalibInit(int page)
     }
     if (calibrate_state == CALI_EXIT)
         memcpy(Transmitter.calibration, cp->calibration, sizeof(cp->calibration));
+    for (u8 i = 0; i < INP_HAS_CALIBRATION; i++)
+        Transmitter.calibration[i].filter = cp->calibration[i].filter;
+    CHAN_UpdateCalibration();
+    CONFIG_MarkChanged();
 
     PAGE_Pop();
 //    PAGE_SetActionCB(NULL);
@@ -179,7 +187,10 @@ static const char *modeselect_cb(guiObject_t *obj, int dir, void *data)
 {
     (void)data;
     (void)obj;
-    Transmitter.mode = GUI_TextSelectHelper(Transmitter.mode, MODE_1, MODE_4, dir, 1, 1, NULL);
+    u8 changed;
+    Transmitter.mode = GUI_TextSelectHelper(Transmitter.mode, MODE_1, MODE_4, dir, 1, 1, &changed);
+    if (changed)
+        MIXER_CompileMixers();  // trim sources follow the stick mode
     snprintf(tempstring, sizeof(tempstring), _tr("Mode %d"), Transmitter.mode);
     return tempstring;
 }
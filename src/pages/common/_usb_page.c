@@ -28,11 +28,35 @@ unsigned usb_cb(u32 button, unsigned flags, void *data)
         _draw_page(1);
         GUI_RefreshScreen();
         CONFIG_SaveModelIfNeeded();
+#if MODEL_CATALOG_SIZE
+        // The PC may edit the models, so have the catalog checked against them
+        CONFIG_ModelCatalogReset();
+#endif
+#if HAS_DATALOG
+        DATALOG_Flush();
+#endif
+#ifdef fs_background
+        // Don't hand the PC an image with a compaction half done
+        while (fs_background())
+            ;
+#endif
+#if STORAGE_CACHE_LINES
+        STORAGE_CacheFlush();
+#endif
         MSC_Enable();
         wait_release();
         wait_press();
         wait_release();
         MSC_Disable();
+#if STORAGE_CACHE_LINES
+        // The PC may have changed anything behind the cache
+        STORAGE_CacheReset();
+#endif
+        MUSIC_LoadSounds();
+#if IMAGE_CACHE_SLOTS
+        LCD_ImageCacheReset();
+#endif
+        FONT_CacheReset();
         CONFIG_ReadModel(Transmitter.current_model);
         _draw_page(0);
     }
@@ -42,6 +42,7 @@ void save_changes()
              : 0;
 
     STDMIXER_SaveSwitches();
+    CONFIG_MarkChanged();
 }
 
 //From common/_main_config.c
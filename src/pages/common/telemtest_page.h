@@ -6,5 +6,14 @@ struct telemtest_page {
     int return_val;
     struct Telemetry telem;
     struct LabelDesc font;
+#if TELEM_HISTORY_SLOTS
+    u8 trend_src;               // source shown as a trend, 0 for the monitor
+    u8 trend_level;
+    u8 trend_count;
+    u32 trend_samples;          // raw samples seen when the trend was read
+    s32 trend_min;
+    s32 trend_max;
+    s32 trend[TELEM_HISTORY_SAMPLES];
+#endif
 };
 #endif
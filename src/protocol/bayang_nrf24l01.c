@@ -28,6 +28,7 @@
 #include "mixer.h"
 #include "config/model.h"
 #include "config/tx.h"          // for Transmitter
+#include "chanpack.h"
 #include "telemetry.h"
 
 #ifdef PROTO_HAS_NRF24L01
@@ -145,18 +146,10 @@ static u8 checksum()
     return sum;
 }
 
-#define CHAN_RANGE (CHAN_MAX_VALUE - CHAN_MIN_VALUE)
-static u16 scale_channel(u8 ch, u16 destMin, u16 destMax)
-{
-    s32 chanval = Channels[ch];
-    s32 range = (s32) destMax - (s32) destMin;
-
-    if (chanval < CHAN_MIN_VALUE)
-        chanval = CHAN_MIN_VALUE;
-    else if (chanval > CHAN_MAX_VALUE)
-        chanval = CHAN_MAX_VALUE;
-    return (range * (chanval - CHAN_MIN_VALUE)) / CHAN_RANGE + destMin;
-}
+// Channel scaling, set up in initialize()
+static struct ChanScale aux_scale;          // 0..0xff
+static struct ChanScale stick_scale;        // 0..0x3ff
+static struct ChanScale stick_rev_scale;    // 0x3ff..0
 
 #define DYNTRIM(chval) ((u8)((chval >> 2) & 0xfc))
 #define GET_FLAG(ch, mask) (Channels[ch] > 0 ? mask : 0)
@@ -217,7 +210,7 @@ static void send_packet(u8 bind)
                     break;
         }
         if (analogaux) {
-            packet[1] = scale_channel(CHANNEL_ANAAUX1, 0, 0xff);
+            packet[1] = CHANPACK_Scale(&aux_scale, Channels[CHANNEL_ANAAUX1]);
         } else {
             packet[1] = 0xfa;       // normal mode is 0xf7, expert 0xfa
         }
@@ -229,16 +222,16 @@ static void send_packet(u8 bind)
         packet[3] = GET_FLAG(CHANNEL_INVERTED, 0x80)
             | GET_FLAG(CHANNEL_TO, 0x20)
             | GET_FLAG(CHANNEL_EMGSTOP, 0x04);
-        chanval.value = scale_channel(CHANNEL1, 0x3ff, 0);      // aileron
+        chanval.value = CHANPACK_Scale(&stick_rev_scale, Channels[CHANNEL1]);      // aileron
         packet[4] = chanval.bytes.msb + DYNTRIM(chanval.value);
         packet[5] = chanval.bytes.lsb;
-        chanval.value = scale_channel(CHANNEL2, 0, 0x3ff);      // elevator
+        chanval.value = CHANPACK_Scale(&stick_scale, Channels[CHANNEL2]);      // elevator
         packet[6] = chanval.bytes.msb + DYNTRIM(chanval.value);
         packet[7] = chanval.bytes.lsb;
-        chanval.value = scale_channel(CHANNEL3, 0, 0x3ff);      // throttle
+        chanval.value = CHANPACK_Scale(&stick_scale, Channels[CHANNEL3]);      // throttle
         packet[8] = chanval.bytes.msb + 0x7c;
         packet[9] = chanval.bytes.lsb;
-        chanval.value = scale_channel(CHANNEL4, 0x3ff, 0);      // rudder
+        chanval.value = CHANPACK_Scale(&stick_rev_scale, Channels[CHANNEL4]);      // rudder
         packet[10] = chanval.bytes.msb + DYNTRIM(chanval.value);
         packet[11] = chanval.bytes.lsb;
     }
@@ -247,7 +240,7 @@ static void send_packet(u8 bind)
             case FORMAT_REGULAR:
                 packet[12] = txid[2];
                 if (analogaux) {
-                    packet[13] = scale_channel(CHANNEL_ANAAUX2, 0, 0xff);
+                    packet[13] = CHANPACK_Scale(&aux_scale, Channels[CHANNEL_ANAAUX2]);
                 } else {
                     packet[13] = 0x0a;
                 }
@@ -553,6 +546,10 @@ static void initialize()
     if (telemetry)
         Telemetry.value[TELEM_DSM_FLOG_VOLT1] = Telemetry.value[TELEM_DSM_FLOG_VOLT2] = 888;    //8.88V In 1/100 of Volts
 
+    CHANPACK_InitRange(&aux_scale, 0, 0xff);
+    CHANPACK_InitRange(&stick_scale, 0, 0x3ff);
+    CHANPACK_InitRange(&stick_rev_scale, 0x3ff, 0);
+
     initialize_txid();
     bay_init();
     phase = Bayang_INIT1;
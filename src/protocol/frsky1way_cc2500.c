@@ -147,22 +147,6 @@ static void frsky_init()
 
 }
 
-static u8 crc8(u32 result, u8 *data, int len)
-{
-    int polynomial = 0x07;
-    for(int i = 0; i < len; i++) {
-        result = result ^ data[i];
-        for(int j = 0; j < 8; j++) {
-            if(result & 0x80) {
-                result = (result << 1) ^ polynomial;
-            } else {
-                result = result << 1;
-            }
-        }
-    }
-    return result & 0xff;
-}
-
 static u8 crc8_le(u32 _result, u8 *data, int len)
 {
     u32 polynomial = 0x83; //x^9 + x^8 + x^7 + 1 
@@ -201,7 +185,7 @@ static void build_bind_packet_1way()
     packet[11] = 0x00;
     packet[12] = 0x00;
     packet[13] = 0x00;
-    packet[14] = crc8(0x93, packet, 14);
+    packet[14] = Crc8Update(0x93, packet, 14);
 }
 
 static u8 calc_channel()
@@ -237,7 +221,7 @@ static void build_data_packet_1way()
             packet[2*i + 7] = value >> 8;
         }
     }
-    packet[14] = crc8(crc, packet, 14);
+    packet[14] = Crc8Update(crc, packet, 14);
 //for(int i = 0; i < 15; i++) printf("%02x ", packet[i]); printf("\n");
 }
 static u16 frsky_cb()
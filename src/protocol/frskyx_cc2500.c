@@ -102,13 +102,6 @@ static const u8 hop_data[] = {
 };
 
 
-static const u16 CRC_Short[] = {
-  0x0000,0x1189,0x2312,0x329b,0x4624,0x57ad,0x6536,0x74bf,
-  0x8c48,0x9dc1,0xaf5a,0xbed3,0xca6c,0xdbe5,0xe97e,0xf8f7,
-};
-
-
-
 static void init_hop_FRSkyX2(void)
 {
     u8 inc = (fixed_id % (HOP_DATA_SIZE - 2)) + 1;              // Increment
@@ -136,21 +129,6 @@ static void init_hop_FRSkyX2(void)
     hop_data_v2[HOP_DATA_SIZE - 1] = 0;                                        // Bind freq
 }
 
-static u16 crcTable(u8 val)
-{
-  u16 word;
-  word = pgm_read_word(&CRC_Short[val & 0x0F]);
-  val /= 16;
-  return word ^ (0x1081 * val);
-}
-
-static u16 crc(u8 *data, u8 len) {
-  u16 crc = 0;
-  for (int i = 0; i < len; i++)
-      crc = (crc << 8) ^ crcTable((u8)(crc >> 8) ^ *data++);
-  return crc;
-}
-
 static void initialize_data(u8 adr)
 {
   CC2500_WriteReg(CC2500_0C_FSCTRL0, fine);                     // Frequency offset hack
@@ -216,7 +194,7 @@ static void frskyX_build_bind_packet()
             packet[i] ^= 0xA7;
     }
 
-    u16 lcrc = crc(&packet[3], packet_size - 4);
+    u16 lcrc = Crc16FrskyUpdate(0, &packet[3], packet_size - 4);
     packet[packet_size - 1] = lcrc >> 8;
     packet[packet_size] = lcrc;
 
@@ -340,7 +318,7 @@ static void frskyX_data_frame() {
 
     memset(&packet[22], 0, packet_size - 23);
 
-    u16 lcrc = crc(&packet[3], packet_size - 4);
+    u16 lcrc = Crc16FrskyUpdate(0, &packet[3], packet_size - 4);
     packet[packet_size - 1] = lcrc >> 8;
     packet[packet_size] = lcrc;
 }
@@ -384,7 +362,7 @@ static void frsky_check_telemetry(u8 *pkt, u8 len) {
         && pkt[0] == TELEM_PKT_SIZE - 3
         && pkt[1] == (fixed_id & 0xff)
         && pkt[2] == (fixed_id >> 8)
-        && crc(&pkt[3], TELEM_PKT_SIZE - 7) == (pkt[TELEM_PKT_SIZE - 4] << 8 | pkt[TELEM_PKT_SIZE - 3])
+        && Crc16FrskyUpdate(0, &pkt[3], TELEM_PKT_SIZE - 7) == (pkt[TELEM_PKT_SIZE - 4] << 8 | pkt[TELEM_PKT_SIZE - 3])
        ) {
         if (pkt[4] & 0x80) {   // distinguish RSSI from VOLT1
             Telemetry.value[TELEM_FRSKY_RSSI] = pkt[4] & 0x7f;
@@ -752,6 +730,9 @@ uintptr_t FRSKYX_Cmds(enum ProtoCmds cmd)
         case PROTOCMD_TELEMETRYRESET:
             frsky_telem_reset();
             return 0;
+        case PROTOCMD_TELEMETRYFRAMES:
+            frsky_process_sport_frames();
+            return 0;
 #endif
         case PROTOCMD_RESET:
         case PROTOCMD_DEINIT:
@@ -19,6 +19,7 @@ enum ProtoCmds {
     PROTOCMD_RANGETESTON,
     PROTOCMD_RANGETESTOFF,
     PROTOCMD_OPTIONSPAGE,
+    PROTOCMD_TELEMETRYFRAMES,
 };
 
 enum TXRX_State {
@@ -19,6 +19,7 @@
 #include "config/model.h"
 #include "config/tx.h"
 #include "protospi.h"
+#include "telemetry.h"
 
 #include <stdlib.h>
 
@@ -117,6 +118,8 @@ void PROTOCOL_Init(u8 force)
     else {
         CLOCK_StartMixer(); // enable mixer updates on timer
         PROTO_Cmds(PROTOCMD_INIT);
+        //Protocols may fill in defaults for their options
+        CONFIG_MarkChanged();
     }
 }
 
@@ -126,6 +129,9 @@ void PROTOCOL_DeInit()
     if(Model.protocol != PROTOCOL_NONE && PROTOCOL_LOADED)
         PROTO_Cmds(PROTOCMD_DEINIT);
     CLOCK_StartMixer(); // run mixer on timer so channels are updated for things like calibration
+#if HAS_EXTENDED_TELEMETRY
+    TELEMETRY_ResetFrames();
+#endif
     proto_state = PROTO_DEINIT;
 }
 
@@ -229,6 +235,8 @@ void PROTOCOL_SetBindState(u32 msec)
         PROTOCOL_SticksMoved(1);  //Initialize Stick position
     } else {
         proto_state &= ~PROTO_BINDING;
+        //Protocols store what they learned while binding in Model
+        CONFIG_MarkChanged();
     }
 }
 
@@ -395,6 +403,19 @@ void PROTOCOL_ResetTelemetry()
         PROTO_Cmds(PROTOCMD_TELEMETRYRESET);
 }
 
+// Let the protocol decode the telemetry frames queued by its interrupt handlers
+void PROTOCOL_ProcessTelemetry()
+{
+#if HAS_EXTENDED_TELEMETRY
+    if (! TELEMETRY_FramesQueued())
+        return;
+    if (Model.protocol != PROTOCOL_NONE && PROTOCOL_LOADED)
+        PROTO_Cmds(PROTOCMD_TELEMETRYFRAMES);
+    else
+        TELEMETRY_ResetFrames();
+#endif
+}
+
 int PROTOCOL_RangeTest(int on)
 {
     if (Model.protocol != PROTOCOL_NONE && PROTOCOL_LOADED) {
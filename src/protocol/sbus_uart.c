@@ -18,6 +18,7 @@
 #include "mixer.h"
 #include "config/model.h"
 #include "config/tx.h"
+#include "chanpack.h"
 #include "telemetry.h"
 
 static const char * const sbus_opts[] = {
@@ -39,42 +40,12 @@ static u8 packet[SBUS_PACKET_SIZE];
 
 //#define STICK_SCALE    869  // full scale at +-125
 #define STICK_SCALE    800  // +/-100 gives 2000/1000 us
+static struct ChanScale chan_scale;  // +/-100 maps to 992 +/- STICK_SCALE
 static void build_rcdata_pkt()
 {
-    int i;
-	u16 channels[SBUS_CHANNELS];
-
-    for (i=0; i < SBUS_CHANNELS; i++) {
-        if (i < Model.num_channels)
-            channels[i] = (u16)(Channels[i] * STICK_SCALE / CHAN_MAX_VALUE + 992);
-        else
-            channels[i] = 992;  // midpoint
-    }
-
 	packet[0] = 0x0f; 
 
-  	packet[1] = (u8) ((channels[0] & 0x07FF));
-  	packet[2] = (u8) ((channels[0] & 0x07FF)>>8 | (channels[1] & 0x07FF)<<3);
-  	packet[3] = (u8) ((channels[1] & 0x07FF)>>5 | (channels[2] & 0x07FF)<<6);
-  	packet[4] = (u8) ((channels[2] & 0x07FF)>>2);
-  	packet[5] = (u8) ((channels[2] & 0x07FF)>>10 | (channels[3] & 0x07FF)<<1);
-  	packet[6] = (u8) ((channels[3] & 0x07FF)>>7 | (channels[4] & 0x07FF)<<4);
-  	packet[7] = (u8) ((channels[4] & 0x07FF)>>4 | (channels[5] & 0x07FF)<<7);
-  	packet[8] = (u8) ((channels[5] & 0x07FF)>>1);
-  	packet[9] = (u8) ((channels[5] & 0x07FF)>>9 | (channels[6] & 0x07FF)<<2);
-  	packet[10] = (u8) ((channels[6] & 0x07FF)>>6 | (channels[7] & 0x07FF)<<5);
-  	packet[11] = (u8) ((channels[7] & 0x07FF)>>3);
-  	packet[12] = (u8) ((channels[8] & 0x07FF));
-  	packet[13] = (u8) ((channels[8] & 0x07FF)>>8 | (channels[9] & 0x07FF)<<3);
-  	packet[14] = (u8) ((channels[9] & 0x07FF)>>5 | (channels[10] & 0x07FF)<<6);  
-  	packet[15] = (u8) ((channels[10] & 0x07FF)>>2);
-  	packet[16] = (u8) ((channels[10] & 0x07FF)>>10 | (channels[11] & 0x07FF)<<1);
-  	packet[17] = (u8) ((channels[11] & 0x07FF)>>7 | (channels[12] & 0x07FF)<<4);
-  	packet[18] = (u8) ((channels[12] & 0x07FF)>>4 | (channels[13] & 0x07FF)<<7);
-  	packet[19] = (u8) ((channels[13] & 0x07FF)>>1);
-  	packet[20] = (u8) ((channels[13] & 0x07FF)>>9 | (channels[14] & 0x07FF)<<2);
-  	packet[21] = (u8) ((channels[14] & 0x07FF)>>6 | (channels[15] & 0x07FF)<<5);
-  	packet[22] = (u8) ((channels[15] & 0x07FF)>>3);
+    CHANPACK_PackChannels(&packet[1], &chan_scale, SBUS_CHANNELS, 11, CHANPACK_LSB_FIRST);
 
 	packet[23] = 0x00; // flags
 	packet[24] = 0x00;
@@ -113,6 +84,7 @@ static u16 serial_cb()
 static void initialize()
 {
     CLOCK_StopTimer();
+    CHANPACK_InitScale(&chan_scale, 0, 992, STICK_SCALE, CHAN_MAX_VALUE);
     if (PPMin_Mode())
     {
         return;
@@ -38,14 +38,9 @@ void CC2500_WriteReg(u8 address, u8 data)
 
 void CC2500_ReadRegisterMulti(u8 address, u8 data[], u8 length)
 {
-    unsigned char i;
-
     CS_LO();
     PROTOSPI_xfer(CC2500_READ_BURST | address);
-    for(i = 0; i < length; i++)
-    {
-        data[i] = PROTOSPI_xfer(0);
-    }
+    PROTOSPI_xfer_burst(NULL, data, length);
     CS_HI();
 }
 
@@ -75,10 +70,7 @@ void CC2500_WriteRegisterMulti(u8 address, const u8 data[], u8 length)
 {
     CS_LO();
     PROTOSPI_xfer(CC2500_WRITE_BURST | address);
-    for(int i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
+    PROTOSPI_xfer_burst(data, NULL, length);
     CS_HI();
 }
 
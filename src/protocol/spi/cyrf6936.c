@@ -60,10 +60,7 @@ static void WriteRegisterMulti(u8 address, const u8 data[], u8 length)
 {
     CS_LO();
     PROTOSPI_xfer(0x80 | address);
-    for(u32 i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
+    PROTOSPI_xfer_burst(data, NULL, length);
     CS_HI();
 }
 
@@ -71,10 +68,7 @@ static void ReadRegisterMulti(u8 address, u8 data[], u8 length)
 {
     CS_LO();
     PROTOSPI_xfer(address);
-    for(u32 i = 0; i < length; i++)
-    {
-        data[i] = PROTOSPI_xfer(0);
-    }
+    PROTOSPI_xfer_burst(NULL, data, length);
     CS_HI();
 }
 
@@ -67,10 +67,7 @@ u8 NRF24L01_WriteRegisterMulti(u8 reg, const u8 data[], u8 length)
 {
     CS_LO();
     u8 res = PROTOSPI_xfer(W_REGISTER | ( REGISTER_MASK & reg));
-    for (u8 i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
+    PROTOSPI_xfer_burst(data, NULL, length);
     CS_HI();
     return res;
 }
@@ -79,10 +76,7 @@ u8 NRF24L01_WritePayload(u8 *data, u8 length)
 {
     CS_LO();
     u8 res = PROTOSPI_xfer(W_TX_PAYLOAD);
-    for (u8 i = 0; i < length; i++)
-    {
-        PROTOSPI_xfer(data[i]);
-    }
+    PROTOSPI_xfer_burst(data, NULL, length);
     CS_HI();
     return res;
 }
@@ -100,10 +94,7 @@ u8 NRF24L01_ReadRegisterMulti(u8 reg, u8 data[], u8 length)
 {
     CS_LO();
     u8 res = PROTOSPI_xfer(R_REGISTER | (REGISTER_MASK & reg));
-    for(u8 i = 0; i < length; i++)
-    {
-        data[i] = PROTOSPI_xfer(0xFF);
-    }
+    PROTOSPI_xfer_burst(NULL, data, length);
     CS_HI();
     return res;
 }
@@ -112,10 +103,7 @@ u8 NRF24L01_ReadPayload(u8 *data, u8 length)
 {
     CS_LO();
     u8 res = PROTOSPI_xfer(R_RX_PAYLOAD);
-    for(u8 i = 0; i < length; i++)
-    {
-        data[i] = PROTOSPI_xfer(0xFF);
-    }
+    PROTOSPI_xfer_burst(NULL, data, length);
     CS_HI();
     return res;
 }
@@ -272,6 +260,13 @@ static int xn297_addr_len;
 static u8  xn297_tx_addr[5];
 static u8  xn297_rx_addr[5];
 static u8  xn297_crc = 0;
+// Precomputed at address/mode change so the per-packet path only handles the payload
+static u8  xn297_tx_hdr[6];     // preamble filler + (scrambled) address as sent on air
+static u8  xn297_tx_hdr_len;
+static u16 xn297_crc_seed;      // crc over the address bytes
+static const u8 xn297_no_scramble[32];
+static const u8 *xn297_tx_mask = xn297_no_scramble; // payload scramble mask for the current address length
+static u8  xn297_rx_mask[32];   // bit-reversed payload scramble mask for reads
 
 const uint8_t xn297_scramble[] = {
     0xe3, 0xb1, 0x4b, 0xea, 0x85, 0xbc, 0xe5, 0x66,
@@ -311,12 +306,10 @@ uint8_t bit_reverse(uint8_t a)
 #else
 uint8_t bit_reverse(uint8_t b_in)
 {
-    uint8_t b_out = 0;
-    for (int i = 0; i < 8; ++i) {
-        b_out = (b_out << 1) | (b_in & 1);
-        b_in >>= 1;
-    }
-    return b_out;
+    static const u8 reversed_nibble[16] = {
+        0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe,
+        0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf};
+    return (reversed_nibble[b_in & 0x0f] << 4) | reversed_nibble[b_in >> 4];
 }
 #endif
 
@@ -336,6 +329,31 @@ u16 crc16_update(u16 crc, u8 a, u8 bits)
     return crc;
 }
 
+static void xn297_update_tables()
+{
+    u8 *hdr = xn297_tx_hdr;
+    if (xn297_addr_len < 4) {
+        // If address length (which is defined by receive address length)
+        // is less than 4 the TX address can't fit the preamble, so the last
+        // byte goes here
+        *hdr++ = 0x55;
+    }
+    for (int i = 0; i < xn297_addr_len; ++i) {
+        hdr[i] = xn297_tx_addr[xn297_addr_len-i-1];
+        if(xn297_scramble_enabled)
+            hdr[i] ^= xn297_scramble[i];
+    }
+    xn297_tx_hdr_len = hdr - xn297_tx_hdr + xn297_addr_len;
+    xn297_crc_seed = Crc16CcittUpdate(initial, hdr, xn297_addr_len);
+
+    xn297_tx_mask = xn297_scramble_enabled ? &xn297_scramble[xn297_addr_len] : xn297_no_scramble;
+    for (int i = 0; i < 32; ++i) {
+        // xn297_scramble only covers 35 bytes of address + payload
+        int idx = xn297_addr_len + i;
+        xn297_rx_mask[i] = xn297_scramble_enabled && idx < (int)sizeof(xn297_scramble)
+                         ? bit_reverse(xn297_scramble[idx]) : 0;
+    }
+}
 
 void XN297_SetTXAddr(const u8* addr, int len)
 {
@@ -356,6 +374,7 @@ void XN297_SetTXAddr(const u8* addr, int len)
     // instead of 0x55 to ensure enough 0-1 transitions to tune the receiver. Still need to experiment
     // with receiving signals.
     memcpy(xn297_tx_addr, addr, len);
+    xn297_update_tables();
 }
 
 
@@ -387,6 +406,7 @@ void XN297_Configure(u8 flags)
 void XN297_SetScrambledMode(const u8 mode)
 {
     xn297_scramble_enabled = mode;
+    xn297_update_tables();
 }
 
 u8 XN297_WritePayload(u8* msg, int len)
@@ -394,34 +414,14 @@ u8 XN297_WritePayload(u8* msg, int len)
     u8 packet[32];
     u8 res;
 
-    int last = 0;
-    if (xn297_addr_len < 4) {
-        // If address length (which is defined by receive address length)
-        // is less than 4 the TX address can't fit the preamble, so the last
-        // byte goes here
-        packet[last++] = 0x55;
-    }
-    for (int i = 0; i < xn297_addr_len; ++i) {
-        packet[last] = xn297_tx_addr[xn297_addr_len-i-1];
-        if(xn297_scramble_enabled)
-            packet[last] ^= xn297_scramble[i];
-        last++;
-    }
-
+    memcpy(packet, xn297_tx_hdr, xn297_tx_hdr_len);
+    int last = xn297_tx_hdr_len;
     for (int i = 0; i < len; ++i) {
         // bit-reverse bytes in packet
-        u8 b_out = bit_reverse(msg[i]);
-        packet[last] = b_out;
-        if(xn297_scramble_enabled)
-            packet[last] ^= xn297_scramble[xn297_addr_len+i];
-        last++;
+        packet[last++] = bit_reverse(msg[i]) ^ xn297_tx_mask[i];
     }
     if (xn297_crc) {
-        int offset = xn297_addr_len < 4 ? 1 : 0;
-        u16 crc = initial;
-        for (int i = offset; i < last; ++i) {
-            crc = crc16_update(crc, packet[i], 8);
-        }
+        u16 crc = Crc16CcittUpdate(xn297_crc_seed, &packet[xn297_tx_hdr_len], len);
         if(xn297_scramble_enabled)
             crc ^= pgm_read_word(&xn297_crc_xorout_scrambled[xn297_addr_len - 3 + len]);
         else
@@ -436,24 +436,14 @@ u8 XN297_WritePayload(u8* msg, int len)
 u8 XN297_WriteEnhancedPayload(u8* msg, int len, int noack, u16 crc_xorout)
 {
     u8 packet[32];
-    u8 scramble_index=0;
+    u8 scramble_index=xn297_addr_len;
     u8 res;
-    int last = 0;
+    int last;
     static int pid=0;
 
     // address
-    if (xn297_addr_len < 4) {
-        // If address length (which is defined by receive address length)
-        // is less than 4 the TX address can't fit the preamble, so the last
-        // byte goes here
-        packet[last++] = 0x55;
-    }
-    for (int i = 0; i < xn297_addr_len; ++i) {
-        packet[last] = xn297_tx_addr[xn297_addr_len-i-1];
-        if(xn297_scramble_enabled)
-            packet[last] ^= xn297_scramble[scramble_index++];
-        last++;
-    }
+    memcpy(packet, xn297_tx_hdr, xn297_tx_hdr_len);
+    last = xn297_tx_hdr_len;
 
     // pcf
     packet[last] = (len << 1) | (pid>>1);
@@ -481,11 +471,7 @@ u8 XN297_WriteEnhancedPayload(u8* msg, int len, int noack, u16 crc_xorout)
 
     // crc
     if (xn297_crc) {
-        int offset = xn297_addr_len < 4 ? 1 : 0;
-        u16 crc = initial;
-        for (int i = offset; i < last; ++i) {
-            crc = crc16_update(crc, packet[i], 8);
-        }
+        u16 crc = Crc16CcittUpdate(xn297_crc_seed, &packet[xn297_tx_hdr_len], last - xn297_tx_hdr_len);
         crc = crc16_update(crc, packet[last] & 0xc0, 2);
         crc ^= crc_xorout;
 
@@ -505,30 +491,25 @@ u8 XN297_ReadPayload(u8* msg, int len)
 {
     // TODO: if xn297_crc==1, check CRC before filling *msg
     u8 res = NRF24L01_ReadPayload(msg, len);
-    for(u8 i=0; i<len; i++) {
-      msg[i] = bit_reverse(msg[i]);
-      if(xn297_scramble_enabled)
-        msg[i] ^= bit_reverse(xn297_scramble[i+xn297_addr_len]);
-    }
+    for(u8 i=0; i<len; i++)
+      msg[i] = bit_reverse(msg[i]) ^ xn297_rx_mask[i];
     return res;
 }
 
 u8 XN297_ReadEnhancedPayload(u8* msg, int len)
 {
     u8 buffer[32];
-    u8 pcf_size; // pcf payload size
     NRF24L01_ReadPayload(buffer, len+2); // pcf + payload
-    pcf_size = buffer[0];
-    if(xn297_scramble_enabled)
-        pcf_size ^= xn297_scramble[xn297_addr_len];
-    pcf_size = pcf_size >> 1;
+    // The payload is shifted by the 2 bits of pid and no_ack following the
+    // 6 bit size, so each byte is split over two descrambled on-air bytes.
+    // bit_reverse(b1 << 2 | b2 >> 6) == bit_reverse(b1) >> 2 | bit_reverse(b2) << 6
+    u8 prev = bit_reverse(buffer[1]) ^ xn297_rx_mask[1];
     for(int i=0; i<len; i++) {
-        msg[i] = bit_reverse((buffer[i+1] << 2) | (buffer[i+2] >> 6));
-        if(xn297_scramble_enabled)
-            msg[i] ^= bit_reverse((xn297_scramble[xn297_addr_len+i+1] << 2) |
-                                  (xn297_scramble[xn297_addr_len+i+2] >> 6));
+        u8 next = bit_reverse(buffer[i+2]) ^ xn297_rx_mask[i+2];
+        msg[i] = (prev >> 2) | (next << 6);
+        prev = next;
     }
-    return pcf_size;
+    return (buffer[0] ^ bit_reverse(xn297_rx_mask[0])) >> 1; // pcf payload size
 }
 //
 // End of XN297 emulation
@@ -562,23 +543,20 @@ void HS6200_SetTXAddr(const u8* addr, u8 len)
     // precompute address crc
     hs6200_crc_init = 0xffff;
     for(int i=0; i<len; i++)
-        hs6200_crc_init = crc16_update(hs6200_crc_init, addr[len-1-i], 8);
+        hs6200_crc_init = Crc16CcittUpdate(hs6200_crc_init, &addr[len-1-i], 1);
     memcpy(hs6200_tx_addr, addr, len);
     hs6200_address_length = len;
 }
 
 static u16 hs6200_calc_crc(u8* msg, u8 len)
 {
-    u8 pos;
     u16 crc = hs6200_crc_init;
     
-    // pcf + payload
-    for(pos=0; pos < len-1; pos++) { 
-        crc = crc16_update(crc, msg[pos], 8);
-    }
-    // last byte (1 bit only)
     if(len > 0) {
-        crc = crc16_update(crc, msg[pos+1], 1);
+        // pcf + payload
+        crc = Crc16CcittUpdate(crc, msg, len - 1);
+        // last byte (1 bit only)
+        crc = crc16_update(crc, msg[len], 1);
     }
     
     return crc;
@@ -639,4 +617,6 @@ u8 HS6200_WritePayload(u8* msg, u8 len)
 // End of HS6200 emulation
 ////////////////////////////
 
+#define TESTNAME nrf24l01
+#include <tests.h>
 #endif // defined(PROTO_HAS_NRF24L01)
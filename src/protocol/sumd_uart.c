@@ -18,6 +18,7 @@
 #include "mixer.h"
 #include "config/model.h"
 #include "config/tx.h"
+#include "chanpack.h"
 #include "telemetry.h"
 
 static const char * const sumd_opts[] = {
@@ -37,35 +38,13 @@ ctassert(LAST_PROTO_OPT <= NUM_PROTO_OPTS, too_many_protocol_opts);
 
 static u8 packet[SUMD_MAX_PACKET_SIZE];
 
-#define CRC_POLYNOME 0x1021
-static u16 crc16(u16 crc, u8 value) {
-    u8 i;
-
-    crc = crc ^ (s16)value << 8;
-
-    for (i=0; i < 8; i++) {
-        if (crc & 0x8000)
-            crc = (crc << 1) ^ CRC_POLYNOME;
-        else
-            crc = (crc << 1);
-    }
-    return crc;
-}
-
-static u16 crc(u8 *data, u8 len) {
-  u16 crc = 0;
-  for (int i=0; i < len; i++)
-      crc = crc16(crc, *data++);
-  return crc;
-}
-
 
 // #define STICK_SCALE    869  // full scale at +-125
 #define STICK_SCALE     3200  // +/-100 gives 15200/8800
 #define STICK_CENTER   12000
+static struct ChanScale chan_scale;
 static int build_rcdata_pkt()
 {
-    u16 chanval;
     u16 crc_val = 0;
     int j = 0;
 
@@ -74,13 +53,9 @@ static int build_rcdata_pkt()
     packet[j++] = 0x01;     // 0x01 normal packet, 0x81 failsafe setting
     packet[j++] = Model.num_channels;
 
-    for (int i=0; i < Model.num_channels; i++) {
-        chanval = (u16)(Channels[i] * STICK_SCALE / CHAN_MAX_VALUE + STICK_CENTER);
-        packet[j++] = chanval >> 8;
-        packet[j++] = chanval;
-    }
+    j += CHANPACK_PackChannels(&packet[j], &chan_scale, Model.num_channels, 16, CHANPACK_MSB_FIRST);
 
-    crc_val = crc(packet, j);
+    crc_val = Crc16CcittUpdate(0, packet, j);
     packet[j++] = crc_val >> 8;
     packet[j++] = crc_val;
 
@@ -117,6 +92,7 @@ static u16 serial_cb() {
 static void initialize()
 {
     CLOCK_StopTimer();
+    CHANPACK_InitScale(&chan_scale, 0, STICK_CENTER, STICK_SCALE, CHAN_MAX_VALUE);
     if (PPMin_Mode())
     {
         return;
@@ -494,34 +494,76 @@ u8 LCD_ImageDimensions(const char *file, u16 *w, u16 *h)
     return 1;
 }
 
-void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h, u16 x_off, u16 y_off)
+#if IMAGE_CACHE_SLOTS
+/* Small bitmaps (icons, arrows, narrow buttons) are kept in RAM with the row
+ * padding stripped so that redrawing them needs no filesystem access */
+#define IMAGE_CACHE_PIXELS 1024
+static struct image_cache {
+    char file[24];
+    u16 w;
+    u16 h;
+    u8 transparent;
+    u16 stamp;
+    u16 data[IMAGE_CACHE_PIXELS];
+} image_cache[IMAGE_CACHE_SLOTS];
+static u16 image_stamp;
+
+void LCD_ImageCacheReset()
 {
-    int i, j;
-    FILE *fh;
-    unsigned transparent = 0;
-    unsigned row_has_transparency = 0;
-    (void)row_has_transparency;
-
-    u8 buf[480 * 2];
+    for (int i = 0; i < IMAGE_CACHE_SLOTS; i++)
+        image_cache[i].file[0] = '\0';
+}
 
-    if (w == 0 || h == 0)
-        return;
+static struct image_cache *image_cache_find(const char *file)
+{
+    for (int i = 0; i < IMAGE_CACHE_SLOTS; i++) {
+        struct image_cache *img = &image_cache[i];
+        if (img->file[0] && strcmp(img->file, file) == 0) {
+            img->stamp = ++image_stamp;
+            return img;
+        }
+    }
+    return NULL;
+}
 
-    fh = fopen(file, "rb");
-    if(! fh) {
-        printf("DEBUG: LCD_DrawWindowedImageFromFile: Image not found: %s\n", file);
-        if (w > 0 && h > 0)
-            LCD_FillRect(x, y, w, h, 0);
-        return;
+static struct image_cache *image_cache_load(FILE *fh, const char *file, u32 offset,
+                                            u32 img_w, u32 img_h, unsigned transparent)
+{
+    if (strlen(file) >= sizeof(image_cache[0].file) || img_w * img_h > IMAGE_CACHE_PIXELS)
+        return NULL;
+    struct image_cache *img = &image_cache[0];
+    for (int i = 1; i < IMAGE_CACHE_SLOTS && img->file[0]; i++) {
+        struct image_cache *slot = &image_cache[i];
+        if (! slot->file[0] || (u16)(image_stamp - slot->stamp) > (u16)(image_stamp - img->stamp))
+            img = slot;
     }
-    setbuf(fh, 0);
-    u32 img_w, img_h, offset, compression;
+    img->file[0] = '\0';
+    fseek(fh, offset, SEEK_SET);
+    u16 *row = img->data;
+    for (unsigned j = 0; j < img_h; j++) {
+        if (fread(row, 2 * img_w, 1, fh) != 1)
+            return NULL;
+        if (img_w % 2)
+            fseek(fh, 2, SEEK_CUR);
+        row += img_w;
+    }
+    strcpy(img->file, file);
+    img->w = img_w;
+    img->h = img_h;
+    img->transparent = transparent;
+    img->stamp = ++image_stamp;
+    return img;
+}
+#endif
+
+static int image_read_bmp_header(FILE *fh, u8 *buf, u32 *img_w, u32 *img_h, u32 *offset, unsigned *transparent)
+{
+    u32 compression;
 
     if(fread(buf, 0x46, 1, fh) != 1 || buf[0] != 'B' || buf[1] != 'M')
     {
-        fclose(fh);
         printf("DEBUG: LCD_DrawWindowedImageFromFile: Buffer read issue?\n");
-        return;
+        return 0;
     }
     compression = *((u32 *)(buf + 0x1e));
     if(*((u16 *)(buf + 0x1a)) != 1      /* 1 plane */
@@ -529,10 +571,10 @@ void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h,
        || (compression != 0 && compression != 3)  /* BI_RGB or BI_BITFIELDS */
       )
     {
-        fclose(fh);
         printf("DEBUG: LCD_DrawWindowedImageFromFile: BMP Format not correct\n");
-        return;
+        return 0;
     }
+    *transparent = 0;
     if(compression == 3)
     {
         if(*((u16 *)(buf + 0x36)) == 0x7c00 
@@ -540,19 +582,119 @@ void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h,
            && *((u16 *)(buf + 0x3e)) == 0x001f
            && *((u16 *)(buf + 0x42)) == 0x8000)
         {
-            transparent = 1;
+            *transparent = 1;
         } else if(*((u16 *)(buf + 0x36)) != 0xf800 
            || *((u16 *)(buf + 0x3a)) != 0x07e0
            || *((u16 *)(buf + 0x3e)) != 0x001f)
         {
-            fclose(fh);
             printf("DEBUG: LCD_DrawWindowedImageFromFile: BMP Format not correct second check\n");
+            return 0;
+        }
+    }
+    *offset = *((u32 *)(buf + 0x0a));
+    *img_w = *((u32 *)(buf + 0x12));
+    *img_h = *((u32 *)(buf + 0x16));
+    return 1;
+}
+
+/* Convert one bitmap row from 'src' into 'dst' (which may be the same buffer)
+ * and send it to the display.  Runs of opaque pixels go out in one
+ * LCD_DrawPixels() call.  Returns 1 if the row skipped transparent pixels */
+static unsigned draw_image_row(const u16 *src, u16 *dst, int w, unsigned transparent,
+                               unsigned x, unsigned y, unsigned last_pixel_transparent)
+{
+    int i;
+    int start = 0;
+
+    if(! transparent) {
+        for (i = 0; i < w; i++) {
+            if (LCD_DEPTH == 1)
+                dst[i] = (src[i] & 0x8410) == 0x8410 ?  0 : 0xffff;
+            else
+                dst[i] = src[i];
+        }
+        LCD_DrawPixels(dst, w);
+        return 0;
+    }
+#ifdef TRANSPARENT_COLOR
+    //Display supports a transparent color
+    (void)x;
+    (void)y;
+    (void)last_pixel_transparent;
+    for (i = 0; i < w; i++) {
+        if((src[i] & 0x8000)) {
+            //convert 1555 -> 565
+            dst[i] = ((src[i] & 0x7fe0) << 1) | (src[i] & 0x1f);
+        } else {
+            LCD_DrawPixels(dst + start, i - start);
+            LCD_DrawPixel(TRANSPARENT_COLOR);
+            start = i + 1;
+        }
+    }
+    LCD_DrawPixels(dst + start, w - start);
+    return 0;
+#else
+    unsigned row_has_transparency = 0;
+    for (i = 0; i < w; i++) {
+        if((src[i] & 0x8000)) {
+            //convert 1555 -> 565
+            dst[i] = ((src[i] & 0x7fe0) << 1) | (src[i] & 0x1f);
+            if(last_pixel_transparent) {
+                LCD_DrawPixelXY(x + i, y, dst[i]);
+                last_pixel_transparent = 0;
+                start = i + 1;
+            }
+        } else {
+            //When we see a transparent pixel, the next real pixel
+            // will need to be drawn with XY coordinates
+            LCD_DrawPixels(dst + start, i - start);
+            start = i + 1;
+            row_has_transparency = 1;
+            last_pixel_transparent = 1;
+        }
+    }
+    LCD_DrawPixels(dst + start, w - start);
+    return row_has_transparency;
+#endif
+}
+
+void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h, u16 x_off, u16 y_off)
+{
+    int j;
+    FILE *fh = NULL;
+    unsigned transparent = 0;
+    unsigned row_has_transparency = 0;
+    const u16 *cached = NULL;
+    u32 img_w = 0, img_h = 0, offset = 0;
+
+    u8 buf[480 * 2];
+
+    if (w == 0 || h == 0)
+        return;
+
+#if IMAGE_CACHE_SLOTS
+    struct image_cache *img = image_cache_find(file);
+    if (img) {
+        cached = img->data;
+        img_w = img->w;
+        img_h = img->h;
+        transparent = img->transparent;
+    }
+#endif
+    if (! cached) {
+        fh = fopen(file, "rb");
+        if(! fh) {
+            printf("DEBUG: LCD_DrawWindowedImageFromFile: Image not found: %s\n", file);
+            if (w > 0 && h > 0)
+                LCD_FillRect(x, y, w, h, 0);
+            return;
+        }
+        setbuf(fh, 0);
+        if (! image_read_bmp_header(fh, buf, &img_w, &img_h, &offset, &transparent)) {
+            fclose(fh);
             return;
         }
     }
-    offset = *((u32 *)(buf + 0x0a));
-    img_w = *((u32 *)(buf + 0x12));
-    img_h = *((u32 *)(buf + 0x16));
     if(w < 0)
         w = img_w;
     if(h < 0)
@@ -561,69 +703,43 @@ void LCD_DrawWindowedImageFromFile(u16 x, u16 y, const char *file, s16 w, s16 h,
     {
         printf("DEBUG: LCD_DrawWindowedImageFromFile (%s): Dimensions asked for are out of bounds\n", file);
         printf("size: (%d x %d) bounds(%d x %d)\n", (u16)img_w, (u16)img_h, (u16)(w + x_off), (u16)(h + y_off));
-        fclose(fh);
+        if (fh)
+            fclose(fh);
         return;
     }
+#if IMAGE_CACHE_SLOTS
+    if (! cached && (img = image_cache_load(fh, file, offset, img_w, img_h, transparent))) {
+        cached = img->data;
+        fclose(fh);
+        fh = NULL;
+    }
+#endif
 
-    offset += (img_w * (img_h - (y_off + h)) + x_off) * 2;
-    fseek(fh, offset, SEEK_SET);
+    if (! cached) {
+        offset += (img_w * (img_h - (y_off + h)) + x_off) * 2;
+        fseek(fh, offset, SEEK_SET);
+    }
     LCD_DrawStart(x, y, x + w - 1, y + h - 1, DRAW_SWNE);
     /* Bitmap start is at lower-left corner */
     for (j = 0; j < h; j++) {
-        if (fread(buf, 2 * w, 1, fh) != 1)
-            break;
-        u16 *color = (u16 *)buf;
-        if(transparent) {
-#ifdef TRANSPARENT_COLOR
-            //Display supports a transparent color
-            for (i = 0; i < w; i++ ) {
-                u32 c;
-                if((*color & 0x8000)) {
-                    //convert 1555 -> 565
-                    c = ((*color & 0x7fe0) << 1) | (*color & 0x1f);
-                } else {
-                    c = TRANSPARENT_COLOR;
-                }
-                LCD_DrawPixel(c);
-                color++;
-            }
-#else
-            unsigned last_pixel_transparent = row_has_transparency;
-            row_has_transparency = 0;
-            for (i = 0; i < w; i++ ) {
-                if((*color & 0x8000)) {
-                    //convert 1555 -> 565
-                    unsigned c = ((*color & 0x7fe0) << 1) | (*color & 0x1f);
-                    if(last_pixel_transparent) {
-                        LCD_DrawPixelXY(x + i, y + h - j - 1, c);
-                        last_pixel_transparent = 0;
-                    } else {
-                        LCD_DrawPixel(c);
-                    }
-                } else {
-                    //When we see a transparent pixel, the next real pixel
-                    // will need to be drawn with XY coordinates
-                    row_has_transparency = 1;
-                    last_pixel_transparent = 1;
-                }
-                color++;
-            }
-#endif
+        const u16 *row = (u16 *)buf;
+        if (cached) {
+            row = cached + (img_h - (y_off + h) + j) * img_w + x_off;
         } else {
-            for (i = 0; i < w; i++ ) {
-                if (LCD_DEPTH == 1)
-                    *color = (*color & 0x8410) == 0x8410 ?  0 : 0xffff;
-                LCD_DrawPixel(*color++);
+            if (fread(buf, 2 * w, 1, fh) != 1)
+                break;
+            if((u16)w < img_w) {
+                fseek(fh, 2 * (img_w - w), SEEK_CUR);
             }
+            // for images with odd width: skip 2 bytes to reach a 4-byte-position (skip padding bytes, see http://en.wikipedia.org/wiki/File:BMPfileFormat.png
+            if ((img_w % 2) == 1) fseek(fh, 2, SEEK_CUR);
         }
-        if((u16)w < img_w) {
-            fseek(fh, 2 * (img_w - w), SEEK_CUR);
-        }
-        // for images with odd width: skip 2 bytes to reach a 4-byte-position (skip padding bytes, see http://en.wikipedia.org/wiki/File:BMPfileFormat.png
-        if ((img_w % 2) == 1) fseek(fh, 2, SEEK_CUR);
+        row_has_transparency = draw_image_row(row, (u16 *)buf, w, transparent,
+                                              x, y + h - j - 1, row_has_transparency);
     }
     LCD_DrawStop();
-    fclose(fh);
+    if (fh)
+        fclose(fh);
 }
 #endif
 
@@ -19,113 +19,250 @@
 static FSHANDLE FontFH;
 
 #define RANGE_TABLE_SIZE 20
+#define FONT_NAME_LEN 9
+#define NUM_FONT_SLOTS 4
+
+/* The GUI switches fonts all the time, so the header of every font opened
+ * recently is kept in RAM.  Each range also stores the index of its first
+ * glyph, so finding a glyph's offset-table entry is a binary search.
+ *
+ * Recently used glyphs are kept in an LRU cache (FONT_CACHE_SIZE entries).
+ * Every entry holds the glyph's file offset and width, and its bitmap too
+ * if it fits in GLYPH_DATA_SIZE bytes, so drawing or measuring a cached
+ * character doesn't touch the filesystem at all.
+ * FONT_CACHE_SIZE is 0 on targets short of RAM, which keeps a single entry
+ * without bitmap data.
+ */
+struct font_range {
+    u16 start;
+    u16 end;
+    u16 index;
+};
 
 static struct font_def
 {
-    FILE *fh;
+    char name[FONT_NAME_LEN];
     u8 height;          /* Character height for storage        */
-    u16 range[2 * (RANGE_TABLE_SIZE + 1)];  /* Array containing the ranges of supported characters */
-}font;
+    u8 num_ranges;
+    u16 stamp;
+    struct font_range range[RANGE_TABLE_SIZE];  /* Ranges of supported characters */
+} fonts[NUM_FONT_SLOTS];
+
+static struct font_def *font;
+static FILE *font_fh;
+
+#if FONT_CACHE_SIZE
+#define GLYPH_SLOTS     FONT_CACHE_SIZE
+#define GLYPH_DATA_SIZE 32
+#else
+#define GLYPH_SLOTS     1
+#define GLYPH_DATA_SIZE 0
+#endif
+static struct glyph {
+    u32 c;
+    u32 begin;
+    u16 stamp;
+    u8 font;            /* font slot + 1, 0 if unused */
+    u8 width;
+    u8 size;            /* bitmap size in bytes */
+    u8 loaded;          /* bitmap is in data[] */
+    u8 data[GLYPH_DATA_SIZE];
+} glyphs[GLYPH_SLOTS];
+static u16 lru_stamp;
+
+static u8 row_bytes()
+{
+    return ((font->height - 1) / 8) + 1;
+}
+
+static u32 get_glyph_index(u32 c)
+{
+    int lo = 0, hi = font->num_ranges - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (c < font->range[mid].start)
+            hi = mid - 1;
+        else if (c > font->range[mid].end)
+            lo = mid + 1;
+        else
+            return font->range[mid].index + c - font->range[mid].start;
+    }
+    //Unknown characters use the first glyph
+    return 0;
+}
 
 static u8 get_char_range(u32 c, u32 *begin, u32 *end)
 {
-    u32 offset = 0;
-    u32 pos = 5;
     u8 buf[6];
-    u16 *range = font.range;
-    while(1) {
-        if (range[0] == 0 && range[1] == 0)
-            break;
-        if (c >= range[0] && c <= range[1]) {
-            pos += 3 * (offset + c - range[0]);
-        } else {
-            offset += range[1] + 1 - range[0];
-        }
-        range += 2;
-        pos += 4;
-    }
-    fseek(font.fh, pos, SEEK_SET);
-    fread(buf, 6, 1, font.fh);
+    //height, ranges and the terminating range precede the offset table
+    u32 pos = 1 + 4 * (font->num_ranges + 1) + 3 * get_glyph_index(c);
+    fseek(font_fh, pos, SEEK_SET);
+    fread(buf, 6, 1, font_fh);
     *begin = buf[0] | (buf[1] << 8) | (buf[2] << 16);
     *end   = buf[3] | (buf[4] << 8) | (buf[5] << 16);
     return 1;
 }
 
-void char_read(u8 *fontbuf, u32 c, u8 *width)
+static struct glyph *get_glyph(u32 c)
 {
-    u32 begin;
-    u32 end;
+    u8 font_id = font - fonts + 1;
+    struct glyph *g, *victim = glyphs;
+    u32 begin, end;
 
-    u8 row_bytes = ((font.height - 1) / 8) + 1;
+    lru_stamp++;
+    for (g = glyphs; g < glyphs + GLYPH_SLOTS; g++) {
+        if (g->font == font_id && g->c == c) {
+            g->stamp = lru_stamp;
+            return g;
+        }
+        if (! g->font || (victim->font && (u16)(lru_stamp - g->stamp) > (u16)(lru_stamp - victim->stamp)))
+            victim = g;
+    }
+    g = victim;
     get_char_range(c, &begin, &end);
-    *width = (end - begin) / row_bytes;
-    fseek(font.fh, begin, SEEK_SET);
     if (end - begin > CHAR_BUF_SIZE) {
         printf("Character '%04d' is larger than allowed size\n", (int)c);
-        end = begin + (CHAR_BUF_SIZE / row_bytes) * row_bytes;
-        *width = (end - begin) / row_bytes;
+        end = begin + (CHAR_BUF_SIZE / row_bytes()) * row_bytes();
     }
-    fread(fontbuf, end - begin, 1, font.fh);
+    g->c = c;
+    g->font = font_id;
+    g->begin = begin;
+    g->size = end - begin;
+    g->width = g->size / row_bytes();
+    g->loaded = 0;
+    g->stamp = lru_stamp;
+    return g;
 }
 
-u8 get_width(u32 c)
+void char_read(u8 *fontbuf, u32 c, u8 *width)
 {
-    u32 begin;
-    u32 end;
+    struct glyph *g = get_glyph(c);
 
-    u8 row_bytes = ((font.height - 1) / 8) + 1;
-    get_char_range(c, &begin, &end);
-    return (end - begin) / row_bytes;
+    *width = g->width;
+    if (g->loaded) {
+        memcpy(fontbuf, g->data, g->size);
+        return;
+    }
+    fseek(font_fh, g->begin, SEEK_SET);
+    fread(fontbuf, g->size, 1, font_fh);
+    if (g->size <= GLYPH_DATA_SIZE) {
+        memcpy(g->data, fontbuf, g->size);
+        g->loaded = 1;
+    }
+}
+
+u8 get_width(u32 c)
+{
+    return get_glyph(c)->width;
 }
 
 u8 get_height()
 {
-    return font.height;
+    return font ? font->height : 0;
 }
 
 void close_font()
 {
-    if(font.fh) {
-        fclose(font.fh);
-        font.fh = NULL;
+    if(font_fh) {
+        fclose(font_fh);
+        font_fh = NULL;
     }
 }
 
-u8 open_font(const char* fontname)
+static void free_font_slot(struct font_def *f)
 {
-    char filename[20];
-    close_font();
-
-    sprintf(filename, "media/%s.fon", fontname);
-    finit(&FontFH, "media");
-    font.fh = fopen2(&FontFH, filename, "rb");
-    if (! font.fh) {
-        printf("Couldn't open font file: %s\n", filename);
-        return 0;
+    u8 font_id = f - fonts + 1;
+    for (struct glyph *g = glyphs; g < glyphs + GLYPH_SLOTS; g++) {
+        if (g->font == font_id)
+            g->font = 0;
     }
-    setbuf(font.fh, 0);
-    if(fread(&font.height, 1, 1, font.fh) != 1) {
+    f->name[0] = 0;
+}
+
+static u8 read_font_header(struct font_def *f)
+{
+    u8 buf[4];
+    u16 index = 0;
+
+    if(fread(&f->height, 1, 1, font_fh) != 1) {
         printf("Failed to read height from font\n");
-        fclose(font.fh);
-        font.fh = NULL;
         return 0;
     }
-
-    int range_idx = 0;
-    u8 buf[4];
+    f->num_ranges = 0;
     while(1) {
-        if (fread(buf, 4, 1, font.fh) != 1) {
+        if (fread(buf, 4, 1, font_fh) != 1) {
             printf("Failed to parse font range table\n");
-            fclose(font.fh);
-            font.fh = NULL;
             return 0;
         }
         u16 start_c = buf[0] | (buf[1] << 8);
         u16 end_c = buf[2] | (buf[3] << 8);
-        font.range[range_idx++] = start_c;
-        font.range[range_idx++] = end_c;
         if (start_c == 0 && end_c == 0)
             break;
+        if (f->num_ranges == RANGE_TABLE_SIZE) {
+            printf("Font has more than %d ranges\n", RANGE_TABLE_SIZE);
+            return 0;
+        }
+        f->range[f->num_ranges].start = start_c;
+        f->range[f->num_ranges].end = end_c;
+        f->range[f->num_ranges].index = index;
+        f->num_ranges++;
+        index += end_c + 1 - start_c;
+    }
+    return 1;
+}
+
+u8 open_font(const char* fontname)
+{
+    char filename[20];
+    struct font_def *f, *slot = fonts;
+    close_font();
+
+    sprintf(filename, "media/%s.fon", fontname);
+    finit(&FontFH, "media");
+    font_fh = fopen2(&FontFH, filename, "rb");
+    if (! font_fh) {
+        printf("Couldn't open font file: %s\n", filename);
+        return 0;
     }
+    setbuf(font_fh, 0);
+    lru_stamp++;
+    for (f = fonts; f < fonts + NUM_FONT_SLOTS; f++) {
+        if (f->name[0] && strcasecmp(f->name, fontname) == 0) {
+            f->stamp = lru_stamp;
+            font = f;
+            return 1;
+        }
+        if (! f->name[0] || (slot->name[0] && (u16)(lru_stamp - f->stamp) > (u16)(lru_stamp - slot->stamp)))
+            slot = f;
+    }
+    free_font_slot(slot);
+    if (! read_font_header(slot)) {
+        fclose(font_fh);
+        font_fh = NULL;
+        return 0;
+    }
+    strlcpy(slot->name, fontname, FONT_NAME_LEN);
+    slot->stamp = lru_stamp;
+    font = slot;
     return 1;
 }
+
+/* Drop every cached header and glyph, for when the font files may have
+ * been replaced (USB).  The current font is read again from its file */
+void FONT_CacheReset()
+{
+    char name[FONT_NAME_LEN];
+
+    name[0] = 0;
+    if (font && font_fh)
+        strlcpy(name, font->name, FONT_NAME_LEN);
+    for (struct font_def *f = fonts; f < fonts + NUM_FONT_SLOTS; f++)
+        f->name[0] = 0;
+    for (struct glyph *g = glyphs; g < glyphs + GLYPH_SLOTS; g++)
+        g->font = 0;
+    if (name[0])
+        open_font(name);
+}
+
+#define TESTNAME font
+#include <tests.h>
@@ -79,6 +79,7 @@ enum DrawDir {
     DRAW_SWNE,
 };
 void LCD_DrawPixel(unsigned int color);
+void LCD_DrawPixels(const u16 *colors, unsigned count);
 void LCD_DrawMappedPixel(unsigned int color);
 void LCD_DrawPixelXY(unsigned int x, unsigned int y, unsigned int color);
 void LCD_DrawMappedPixelXY(unsigned int x, unsigned int y, unsigned int color);
@@ -177,6 +178,10 @@ extern void CHAN_SetButtonCfg(const char *str);
 s32 ADC_ReadRawInput(int channel);
 s32 SWITCH_ReadRawInput(int channel);
 s32 ADC_NormalizeChannel(int channel);
+void ADC_Filter();
+void CHAN_UpdateCalibration();
+s32 CHAN_ScaleInput(int channel, s32 value);
+s32 CHAN_FilterInput(int channel, s32 value);
 
 /* SPI Flash */
 void SPIFlash_Init();
@@ -232,6 +237,21 @@ void MMC_Init();
 #error Define FLASHTYPE to FLASHTYPE_MCU or FLASHTYPE_SPI or FLASHTYPE_MMC
 #endif
 
+/* Sector cache between petit_fat/devofs and the storage driver */
+#if FLASHTYPE == FLASHTYPE_MMC || (defined(EMULATOR) && EMULATOR == USE_NATIVE_FS && ! defined(TEST))
+    // FatFs buffers its own sectors, and the native emulator has no flash to cache
+    #undef STORAGE_CACHE_LINES
+    #define STORAGE_CACHE_LINES 0
+#endif
+#if STORAGE_CACHE_LINES
+void STORAGE_CacheReadBytes(u32 readAddress, u32 length, u8 * buffer);
+int  STORAGE_CacheReadBytesStopCR(u32 readAddress, u32 length, u8 * buffer);
+void STORAGE_CacheWriteBytes(u32 writeAddress, u32 length, const u8 * buffer);
+void STORAGE_CacheEraseSector(u32 sectorAddress);
+void STORAGE_CacheFlush();
+void STORAGE_CacheReset();
+#endif
+
 
 /* Sound */
 void SOUND_Init();
@@ -107,6 +107,22 @@ void LCD_DrawPixel(unsigned int color)
     LCD_DATA = color;
 }
 
+void LCD_DrawPixels(const u16 *colors, unsigned count)
+{
+    // The controller auto-increments within the window, so a whole row is
+    // streamed back-to-back over FSMC without per-pixel call overhead
+    while (count >= 4) {
+        LCD_DATA = colors[0];
+        LCD_DATA = colors[1];
+        LCD_DATA = colors[2];
+        LCD_DATA = colors[3];
+        colors += 4;
+        count -= 4;
+    }
+    while (count--)
+        LCD_DATA = *colors++;
+}
+
 void LCD_DrawPixelXY(unsigned int x, unsigned int y, unsigned int color)
 {
     lcd_set_pos(x, y);
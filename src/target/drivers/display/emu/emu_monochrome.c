@@ -42,6 +42,12 @@ void LCD_DrawPixel(unsigned int color)
     }
 }
 
+void LCD_DrawPixels(const u16 *colors, unsigned count)
+{
+    while (count--)
+        LCD_DrawPixel(*colors++);
+}
+
 void LCD_Clear(unsigned int color) {
 	(void)color;
 	memset(gui.image, 0xaa, sizeof(gui.image));
@@ -194,6 +194,12 @@ void LCD_DrawPixel(unsigned int color)
     }
 }
 
+void LCD_DrawPixels(const u16 *colors, unsigned count)
+{
+    while (count--)
+        LCD_DrawPixel(*colors++);
+}
+
 void LCD_DrawPixelXY(unsigned int x, unsigned int y, unsigned int color)
 {
     xpos = x;
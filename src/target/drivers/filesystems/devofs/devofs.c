@@ -11,13 +11,20 @@
 #ifndef DEVOFS_CREATE_FILE
     #define DEVOFS_CREATE_FILE 0
 #endif
+//Reclaim deleted space a little at a time from df_compact_step() instead of all at once when a file doesn't fit
+#ifndef DEVOFS_BACKGROUND_COMPACT
+    #define DEVOFS_BACKGROUND_COMPACT 1
+#endif
 
 enum {
     SECTOR_SIZE         = 4096,
     MINIMUM_EXTRA_BYTES = 4096,
     MINIMUM_NEW_FILE_SIZE = 8192,
     SECTOR_COUNT        = 16,
-    BUF_SIZE            = 100,
+    COPY_SIZE           = 256,  //bytes moved per flash read/write while compacting
+    STEP_SIZE           = 1024, //bytes copied per df_compact_step() call
+    MARK_DIR            = 0xFF, //parent_dir of a compaction mark
+    LOG_PASS            = SECTOR_COUNT * (SECTOR_SIZE - 1), //bytes a walk covers going once round the flash
 };
 
 enum {
@@ -26,14 +33,16 @@ enum {
     SECTORID_DATA  = 0x02,
 };
 
-#define FILE_SIZE(x) ((x).type == FILEOBJ_DIR ? 0 : (((x).size1 << 16) | ((x).size2 << 8) | (x).size3))
+#define FILE_IS_DIR(x) (((x).type | FILEOBJ_DELMASK) == FILEOBJ_DIRDEL)
+#define FILE_SIZE(x) (FILE_IS_DIR(x) ? 0 : (((x).size1 << 16) | ((x).size2 << 8) | (x).size3))
 #define FILE_ID(x) ((x).size1)
 #define FILE_DELETED(x) (((x).type & FILEOBJ_DELMASK) == FILEOBJ_DELMASK)
+#define FILE_LIVE(x) ((x).type == FILEOBJ_FILE || (x).type == FILEOBJ_DIR)
 /* This assumes flash reset = 0x00.  bits are defined to ensure only 1 type can e set before a reset happens */
 enum {
     FILEOBJ_NONE    = 0x00,
     FILEOBJ_FILE    = 0x43,
-    FILEOBJ_WRITE   = 0x03, //File is being written (this state will never be written to disk)
+    FILEOBJ_WRITE   = 0x03, //File is being written (only on disk for a copy made by a compaction run)
     FILEOBJ_DIR     = 0x41,
     FILEOBJ_FILEDEL = 0xC3,
     FILEOBJ_DIRDEL  = 0xC1,
@@ -42,12 +51,170 @@ enum {
 static FATFS *_fs, *_mountfs;
 
 static int _spiread(void * buf, int addr, int len);
+static int _spiwrite(const void* buf, int addr, int len);
 static int _get_addr(int addr, int offset);
+static int _get_free_space();
 
 static inline int _get_next_sector(int sec) {
     return (sec + 1) % SECTOR_COUNT;
 }
 
+/* Hash table of the live (not deleted) headers, keyed by parent dir and name.
+ * Built at mount and kept current on create/delete and as compaction moves
+ * objects, so opening a file doesn't walk the whole log.  Only the header
+ * address is kept; the size (and name, to rule out hash collisions) is read
+ * from the header itself when an entry matches.
+ * The filesystem is 64kB so an address fits in a u16, and address 0 is a
+ * sector id, never a header:  addr == 0 marks a deleted entry, key == 0 an
+ * unused slot.  The table is supplied by df_set_index().  Without one, or if
+ * it fills up, lookups fall back to scanning */
+static struct {
+    struct index_entry *entry;
+    u16 size;
+    u8 valid;
+} _index;
+
+void df_set_index(struct index_entry *entry, unsigned size)
+{
+    _index.entry = entry;
+    _index.size = size;
+    _index.valid = 0;
+}
+
+static u16 _index_key(int parent_dir, const char *name)
+{
+    u16 key = parent_dir;
+    for (int i = 0; i < 11; i++)
+        key = key * 31 + (u8)name[i];
+    return key ? key : 1;
+}
+
+static void _index_add(const struct file_header *fh, int addr)
+{
+    u16 key = _index_key(fh->parent_dir, fh->name);
+    for (int i = 0; i < _index.size; i++) {
+        struct index_entry *e = &_index.entry[(key + i) & (_index.size - 1)];
+        if (! e->key || ! e->addr) {
+            e->addr = addr;
+            e->key = key;
+            e->parent_dir = fh->parent_dir;
+            return;
+        }
+    }
+    _index.valid = 0;
+}
+
+//Points the entry for the object at from to to, or drops it if to is 0
+static void _index_move(int from, int to)
+{
+    for (int i = 0; i < _index.size; i++) {
+        if (_index.entry[i].key && _index.entry[i].addr == from)
+            _index.entry[i].addr = to;
+    }
+}
+#define _index_remove(addr) _index_move(addr, 0)
+
+static void _index_clear()
+{
+    if (_index.size)
+        memset(_index.entry, 0, _index.size * sizeof(struct index_entry));
+    _index.valid = _index.size != 0;
+}
+
+//Position in the log, used to return directory entries in the order they were written
+static int _index_log_pos(int addr)
+{
+    return (addr - _mountfs->start_sector * SECTOR_SIZE + SECTOR_COUNT * SECTOR_SIZE)
+           % (SECTOR_COUNT * SECTOR_SIZE);
+}
+
+/* Where the log ends and how much of it is deleted, kept up to date in RAM so
+ * appending a file doesn't walk the log and compaction can be started before
+ * it is needed.
+ * A compaction run copies the live objects from the head of the log to its
+ * end and erases each head sector once nothing in it is needed anymore, so
+ * the flash never holds less than one valid copy of every file.  The run
+ * begins by padding the log to a sector boundary ('split') with a mark object.
+ * The log then reads as the objects from 'read' up to split, which are still
+ * to be copied, followed by everything from split on.  When head sectors are
+ * erased, split becomes the start sector and a new mark at the end of the log
+ * records where the uncopied objects resume, so a restart can pick up the run
+ * from the log alone */
+static struct {
+    int end;        //where the next object will be written
+    int reclaim;    //bytes held by deleted objects (and marks)
+    int largest;    //size of the biggest object written since the last scan
+    int read;       //next object to copy, 0 if no compaction is running
+    int split;      //where the objects copied by the running compaction start
+    int copy_to;    //copy in progress, 0 if none
+    int copy_pos;   //bytes of its data copied so far
+    int copy_len;
+} _log;
+
+struct log_walk {
+    int end;
+    int full;       //came all the way round the flash without finding the end
+    int resume;     //from the last mark, 0 if its compaction run completed
+    int split;
+};
+
+static int _log_start()
+{
+    return _log.read ? _log.read : _mountfs->start_sector * SECTOR_SIZE + 1;
+}
+
+static void _set_start(int sector)
+{
+    for (FATFS *head = _mountfs; head; head = head->next) {
+        head->start_sector = sector;
+        head->compact_sector = sector == 0 ? SECTOR_COUNT-1 : sector-1;
+    }
+}
+
+static int _is_mark(const struct file_header *fh)
+{
+    return fh->type == FILEOBJ_FILEDEL && fh->parent_dir == MARK_DIR && memcmp(fh->name, "compact", 7) == 0;
+}
+
+/* Follows the log from the start of sector to its end, stopping early (and
+ * returning 1) if it reaches the address stop.  The walk gives up after one
+ * pass over the flash, as a log with no free header left never ends */
+static int _walk_log(int sector, int stop, struct log_walk *w)
+{
+    struct file_header fh;
+    int addr = sector * SECTOR_SIZE + 1;
+    int walked = 0;
+    w->resume = w->split = w->full = 0;
+    _spiread(&fh, addr, sizeof(struct file_header));
+    while(fh.type != FILEOBJ_NONE) {
+        if (_is_mark(&fh)) {
+            w->resume = ((u8)fh.name[7] << 8) | (u8)fh.name[8];
+            w->split = (u8)fh.name[9] * SECTOR_SIZE + 1;
+        }
+        walked += sizeof(struct file_header) + FILE_SIZE(fh);
+        if (walked >= LOG_PASS) {
+            w->full = 1;
+            break;
+        }
+        addr = _get_addr(addr, sizeof(struct file_header) + FILE_SIZE(fh));
+        if (addr == stop)
+            return 1;
+        _spiread(&fh, addr, sizeof(struct file_header));
+    }
+    w->end = addr;
+    if (w->resume == w->split)
+        w->resume = 0;
+    return 0;
+}
+
+//Sector holding the oldest object still in use
+static int _walk_head(int sector)
+{
+    struct log_walk w;
+    _walk_log(sector, -1, &w);
+    return w.resume ? w.resume / SECTOR_SIZE : sector;
+}
+
 void _write_sector_id(int sector, u8 id) {
     disk_writep_rand(&id, sector, 0, 1);
 }
@@ -70,14 +237,107 @@ void _fill_fileinfo(FATFS *dir, FILINFO *fi) {
     fi->fsize = FILE_SIZE(dir->file_header);
 }
 
+static void _write_mark(int resume, int pad)
+{
+    struct file_header fh;
+    fh.type = FILEOBJ_FILEDEL;
+    fh.parent_dir = MARK_DIR;
+    memcpy(fh.name, "compact", 7);
+    fh.name[7] = resume >> 8;
+    fh.name[8] = resume;
+    fh.name[9] = _log.split / SECTOR_SIZE;
+    fh.name[10] = 0;
+    fh.size1 = 0;
+    fh.size2 = pad >> 8;
+    fh.size3 = pad;
+    _spiwrite(&fh, _log.end, sizeof(struct file_header));
+    _log.end = _get_addr(_log.end, sizeof(struct file_header) + pad);
+    _log.reclaim += sizeof(struct file_header) + pad;
+}
+
+/* Rebuilds the RAM state from the log, finishing anything an interrupted
+ * compaction left half done */
+static void _log_scan()
+{
+    struct log_walk w;
+    struct file_header fh, first;
+    _walk_log(_mountfs->start_sector, -1, &w);
+    memset(&_log, 0, sizeof(_log));
+    _log.end = w.end;
+    if (w.resume) {
+        int split_sector = w.split / SECTOR_SIZE;
+        if (_mountfs->start_sector != split_sector && w.resume / SECTOR_SIZE != _mountfs->start_sector) {
+            //Stopped between the mark and moving the start sector
+            _write_sector_id(split_sector, SECTORID_START);
+        }
+        _log.read = w.resume;
+        _log.split = w.split;
+    }
+    _index_clear();
+    int addr = _log_start();
+    int first_live = 0, first_copy = 0;
+    int copied = _log.read == 0;
+    int walked = 0;
+    _spiread(&fh, addr, sizeof(struct file_header));
+    while(fh.type != FILEOBJ_NONE) {
+        int len = sizeof(struct file_header) + FILE_SIZE(fh);
+        walked += len;
+        if (walked > LOG_PASS)
+            break;
+        if (addr == _log.split)
+            copied = 1;
+        if (fh.type == FILEOBJ_WRITE) {
+            //Stopped while copying this object
+            fh.type = FILEOBJ_FILEDEL;
+            disk_writep_rand(&fh.type, addr / SECTOR_SIZE, addr % SECTOR_SIZE, 1);
+        }
+        if (FILE_LIVE(fh)) {
+            if (! copied && ! first_live) {
+                first_live = addr;
+                first = fh;
+            } else if (copied && first_live && memcmp(&fh, &first, sizeof(struct file_header)) == 0) {
+                first_copy = addr;
+            }
+            if (len > _log.largest)
+                _log.largest = len;
+            _index_add(&fh, addr);
+        } else {
+            _log.reclaim += len;
+        }
+        addr = _get_addr(addr, len);
+        _spiread(&fh, addr, sizeof(struct file_header));
+    }
+    if (first_copy) {
+        //Stopped after copying the first uncopied object but before deleting the original
+        first.type |= FILEOBJ_DELMASK;
+        disk_writep_rand(&first.type, first_live / SECTOR_SIZE, first_live % SECTOR_SIZE, 1);
+        _index_remove(first_live);
+        _log.reclaim += sizeof(struct file_header) + FILE_SIZE(first);
+    }
+    int head = _log.read ? _log.read / SECTOR_SIZE : _mountfs->start_sector;
+    _set_start(head);
+    if (w.full) {
+        //No room left at all: the next write has to compact first
+        _log.end = _mountfs->compact_sector * SECTOR_SIZE + 1;
+        return;
+    }
+    //Erase whatever an interrupted compaction left between the end and the head of the log
+    for (int i = _get_next_sector(_log.end / SECTOR_SIZE); i != head; i = _get_next_sector(i)) {
+        u8 id;
+        disk_readp(&id, i, 0, 1);
+        if (id != SECTORID_EMPTR)
+            disk_erasep(i);
+    }
+}
+
 FRESULT df_compact()
 {
     FATFS *head = _mountfs;
-    u8 buf[BUF_SIZE];
+    u8 buf[COPY_SIZE];
     u8 *buf_ptr;
     struct file_header fh;
     //printf("Start: %08x %08x %08x %08x\n", _fs->start_sector, _fs->compact_sector, _fs->file_addr, _fs->file_cur_pos);
-    int read_addr = _fs->start_sector * SECTOR_SIZE + 1;
+    int read_addr = _log_start();
     int write_sec = _fs->compact_sector;
     int write_off = 1;
     int buf_len;
@@ -92,10 +352,11 @@ FRESULT df_compact()
             head = head->next;
         }
         _spiread(&fh, read_addr, sizeof(struct file_header));
-        if (fh.type == FILEOBJ_NONE)
+        //A full log runs on into the sector being written
+        if (fh.type == FILEOBJ_NONE || read_addr / SECTOR_SIZE == _fs->compact_sector)
             break;
         int len = FILE_SIZE(fh);
-        if (FILE_DELETED(fh)) {
+        if (! FILE_LIVE(fh)) {
             read_addr = _get_addr(read_addr, sizeof(struct file_header) + len);
             continue;
         }
@@ -125,7 +386,7 @@ FRESULT df_compact()
             }
             if (! len)
                 break;
-            buf_len = len > BUF_SIZE ? BUF_SIZE : len;
+            buf_len = len > COPY_SIZE ? COPY_SIZE : len;
             _spiread(buf, read_addr, buf_len);
             buf_ptr = buf;
             len -= buf_len;
@@ -133,24 +394,170 @@ FRESULT df_compact()
         }
     }
     //erase remaining sectors
-    int last_sec = write_sec;
     write_sec = _get_next_sector(write_sec);
     while (write_sec != _fs->compact_sector) {
         disk_erasep(write_sec);
-        last_sec = write_sec;
         write_sec = _get_next_sector(write_sec);
     }
     //update _fs
-    head = _mountfs;
-    while(head) {
-        head->start_sector = _fs->compact_sector;
-        head->compact_sector = last_sec;
-        //printf("End: %08x %08x %08x %08x\n", head->start_sector, head->compact_sector, head->file_addr, head->file_cur_pos);
-        head = head->next;
-    }
+    _set_start(_fs->compact_sector);
+    _log_scan();
     return FR_OK;
 }
 
+#if DEVOFS_BACKGROUND_COMPACT
+static int _compact_begin()
+{
+    int pad = 0;
+    if (_log.end % SECTOR_SIZE != 1) {
+        pad = SECTOR_SIZE - _log.end % SECTOR_SIZE - sizeof(struct file_header);
+        if (pad < 0)
+            pad += SECTOR_SIZE - 1;
+    }
+    //Nothing is erased until a whole sector has been copied, and the largest object must fit too
+    if (_get_free_space() < pad + SECTOR_SIZE + _log.largest)
+        return 0;
+    _log.read = _mountfs->start_sector * SECTOR_SIZE + 1;
+    _log.split = pad ? _get_addr(_log.end, sizeof(struct file_header) + pad) : _log.end;
+    _write_mark(_log.read, pad);
+    return 1;
+}
+
+//Erases the head sectors once everything in them has been copied
+static int _compact_release()
+{
+    int sector = _log.read / SECTOR_SIZE;
+    if (sector == _mountfs->start_sector)
+        return 1;
+    if (_get_free_space() < (int)sizeof(struct file_header))
+        return 0;
+    _write_mark(_log.read, 0);
+    int split_sector = _log.split / SECTOR_SIZE;
+    u8 id;
+    disk_readp(&id, split_sector, 0, 1);
+    if (id != SECTORID_START)
+        _write_sector_id(split_sector, SECTORID_START);
+    for (int i = _mountfs->start_sector; i != sector; i = _get_next_sector(i))
+        disk_erasep(i);
+    _set_start(sector);
+    return 1;
+}
+
+static void _compact_copied()
+{
+    struct file_header fh;
+    _spiread(&fh, _log.read, sizeof(struct file_header));
+    //If the original was deleted meanwhile, so is the copy
+    disk_writep_rand(&fh.type, _log.copy_to / SECTOR_SIZE, _log.copy_to % SECTOR_SIZE, 1);
+    if (! FILE_DELETED(fh)) {
+        fh.type |= FILEOBJ_DELMASK;
+        disk_writep_rand(&fh.type, _log.read / SECTOR_SIZE, _log.read % SECTOR_SIZE, 1);
+        _index_move(_log.read, _log.copy_to);
+        for (FATFS *head = _mountfs; head; head = head->next) {
+            if (head->file_addr == _log.read)
+                head->file_addr = _log.copy_to;
+        }
+    }
+    _log.read = _get_addr(_log.read, sizeof(struct file_header) + _log.copy_len);
+    _log.copy_to = 0;
+}
+
+/* Copies about budget bytes.  Returns 1 if there is more to do, 0 once the
+ * run is done or if it is stuck for lack of space (_log.read stays set) */
+static int _compact_run(int budget)
+{
+    struct file_header fh;
+    u8 buf[COPY_SIZE];
+    while (budget > 0) {
+        if (_log.copy_to) {
+            int len = _log.copy_len - _log.copy_pos;
+            if (! len) {
+                _compact_copied();
+                continue;
+            }
+            if (len > COPY_SIZE)
+                len = COPY_SIZE;
+            int offset = sizeof(struct file_header) + _log.copy_pos;
+            _spiread(buf, _get_addr(_log.read, offset), len);
+            _spiwrite(buf, _get_addr(_log.copy_to, offset), len);
+            _log.copy_pos += len;
+            budget -= len;
+            continue;
+        }
+        if (! _compact_release())
+            return 0;
+        if (_log.read == _log.split) {
+            _log.read = 0;
+            return 0;
+        }
+        _spiread(&fh, _log.read, sizeof(struct file_header));
+        int len = FILE_SIZE(fh);
+        if (! FILE_LIVE(fh)) {
+            _log.reclaim -= sizeof(struct file_header) + len;
+            _log.read = _get_addr(_log.read, sizeof(struct file_header) + len);
+            continue;
+        }
+        //Keep room for the mark written when the head sector is released
+        if (len + 2 * (int)sizeof(struct file_header) > _get_free_space())
+            return 0;
+        //A file copy stays hidden until all of its data is there
+        if (fh.type == FILEOBJ_FILE)
+            fh.type = FILEOBJ_WRITE;
+        _spiwrite(&fh, _log.end, sizeof(struct file_header));
+        _log.copy_to = _log.end;
+        _log.copy_pos = 0;
+        _log.copy_len = len;
+        _log.end = _get_addr(_log.end, sizeof(struct file_header) + len);
+        budget -= sizeof(struct file_header);
+    }
+    return 1;
+}
+
+static void _compact_finish()
+{
+    while (_compact_run(SECTOR_SIZE))
+        ;
+    if (_log.read)
+        df_compact();
+}
+#else
+    #define _compact_finish() df_compact()
+#endif
+
+//Makes room for size bytes if at all possible
+static void _compact_all(int size)
+{
+    if (_log.read)
+        _compact_finish();
+    if (size > _get_free_space() && _log.reclaim)
+        df_compact();
+}
+
+/* Moves compaction along from the main loop.  A run is started once enough
+ * has been deleted and the free space is getting low, early enough for it to
+ * finish before a file save runs out of space.
+ * Returns 1 while a run is in progress */
+int df_compact_step()
+{
+#if DEVOFS_BACKGROUND_COMPACT
+    if (! _mountfs)
+        return 0;
+    for (FATFS *head = _mountfs; head; head = head->next) {
+        if (head->file_header.type == FILEOBJ_WRITE && head->file_cur_pos != -1)
+            return 0;
+    }
+    if (! _log.read) {
+        if (_log.reclaim < MINIMUM_NEW_FILE_SIZE || _get_free_space() >= _log.largest + 2 * MINIMUM_NEW_FILE_SIZE)
+            return 0;
+        if (! _compact_begin())
+            return 0;
+    }
+    return _compact_run(STEP_SIZE);
+#else
+    return 0;
+#endif
+}
+
 int _spiread(void * buf, int addr, int len)
 {
     int sector = addr / SECTOR_SIZE;
@@ -236,27 +643,47 @@ int _find_start_sector(int *recovery_sector)
     return start[0];
 }
 
+/* With two start sectors, either a compaction run has just moved the start of
+ * the log to 'split', so the old start leads up to the new one, or df_compact()
+ * stopped while filling the sector in front of the head of the log */
+static int _pick_start_sector(int a, int b)
+{
+    struct log_walk w;
+    if (_get_next_sector(a) == _walk_head(b))
+        return b;
+    if (_get_next_sector(b) == _walk_head(a))
+        return a;
+    if (_walk_log(a, b * SECTOR_SIZE + 1, &w))
+        return b;
+    return a;
+}
+
 /* Mount/Unmount a logical drive */
 FRESULT df_mount (FATFS* fs)
 {
     _fs = fs;
     _mountfs = fs;
+    if (! fs)
+        return FR_OK;
     fs->file_addr = -1;
     fs->file_cur_pos = -1;
     fs->parent_dir = 0;
     fs->next = NULL;
     disk_initialize();
-    fs->start_sector = _find_start_sector(&fs->compact_sector);
+    int recovery_sector;
+    fs->start_sector = _find_start_sector(&recovery_sector);
     if (fs->start_sector  == -1) {
         return FR_NO_FILESYSTEM;
     }
-    if (fs->compact_sector >= 0) {
-        return df_compact(fs);
+    if (recovery_sector >= 0) {
+        fs->start_sector = _pick_start_sector(fs->start_sector, recovery_sector);
     }
-    fs->compact_sector = fs->start_sector == 0 ? SECTOR_COUNT-1 : fs->start_sector-1;
+    _log_scan();
+    if (_log.read && ! DEVOFS_BACKGROUND_COMPACT)
+        _compact_finish();
 
     //Must initialize file_addr and file_header in case the 1st action on the FS is a write
-    fs->file_addr = fs->start_sector * SECTOR_SIZE + 1; //reset current position
+    fs->file_addr = _log_start(); //reset current position
     _spiread(&fs->file_header, fs->file_addr, sizeof(struct file_header));
     return FR_OK;
 }
@@ -274,7 +701,7 @@ FRESULT df_add_file_descriptor (FATFS *fs)
     head->next = fs;
 
     //Must initialize file_addr and file_header in case the 1st action on the FS is a write
-    fs->file_addr = fs->start_sector * SECTOR_SIZE + 1; //reset current position
+    fs->file_addr = _log_start(); //reset current position
     _spiread(&fs->file_header, fs->file_addr, sizeof(struct file_header));
     
     return FR_OK;
@@ -323,10 +750,28 @@ FRESULT _find_file(FATFS *fs, const char *fullname)
    char name[11];
 
    _format_filename(fullname, name);
+   if (_index.valid) {
+       u16 key = _index_key(fs->parent_dir, name);
+       for (int i = 0; i < _index.size; i++) {
+           struct index_entry *e = &_index.entry[(key + i) & (_index.size - 1)];
+           if (! e->key)
+               break;
+           if (e->key != key || e->parent_dir != fs->parent_dir || ! e->addr)
+               continue;
+           _spiread(&fs->file_header, e->addr, sizeof(struct file_header));
+           if (! FILE_DELETED(fs->file_header) && fs->parent_dir == fs->file_header.parent_dir && memcmp(fs->file_header.name, name, 11) == 0) {
+               fs->file_addr = e->addr;
+               fs->file_cur_pos = -1;
+               return FR_OK;
+           }
+       }
+       fs->file_header.type = FILEOBJ_NONE;
+       return FR_NO_PATH;
+   }
    _spiread(&fs->file_header, fs->file_addr, sizeof(struct file_header));
 
    while(fs->file_header.type != FILEOBJ_NONE) {
-       if (! FILE_DELETED(fs->file_header) && fs->parent_dir == fs->file_header.parent_dir && memcmp(fs->file_header.name, name, 11) == 0) {
+       if (FILE_LIVE(fs->file_header) && fs->parent_dir == fs->file_header.parent_dir && memcmp(fs->file_header.name, name, 11) == 0) {
            //Found matching file
            fs->file_cur_pos = -1;
            return FR_OK;
@@ -341,7 +786,7 @@ int _find_parent_dir(FATFS *fs, const char *path, char *cur_dir)
 {
     int i = 0;
     fs->parent_dir = 0;
-    fs->file_addr = _fs->start_sector * SECTOR_SIZE + 1; //reset current position
+    fs->file_addr = _log_start(); //reset current position
     int cur_idx = 0;
     //Find file's owner directory
     while(1) {
@@ -351,7 +796,8 @@ int _find_parent_dir(FATFS *fs, const char *path, char *cur_dir)
                 return FR_NO_PATH;
             }
             fs->parent_dir = FILE_ID(fs->file_header);
-            _get_next_fileobj(fs); //get the next file object
+            //Compaction can copy a directory past its contents
+            fs->file_addr = _log_start();
             cur_idx = 0;
         } else {
             cur_dir[cur_idx++] = path[i];
@@ -370,7 +816,7 @@ FRESULT df_opendir (DIR *dir, const char *name)
     *dir = *_fs;
 
     // First check if this is the root directory
-    dir->file_addr = _fs->start_sector * SECTOR_SIZE + 1; //reset current position
+    dir->file_addr = _log_start(); //reset current position
     dir->parent_dir = 0;
     if (name[0] == 0 || (name[0] == '/' && name[1] == 0)) {
         dir->file_cur_pos = -1;
@@ -397,9 +843,39 @@ FRESULT df_readdir (DIR *dir, FILINFO *fi)
     if (dir->file_addr == -1) {
         return FR_NO_FILE;
     }
+    if (_index.valid) {
+        //Return the next entry of this directory in log order
+        int min_pos = 0;
+        if (dir->file_cur_pos == -1) {
+            dir->file_cur_pos = 0;
+        } else {
+            if (dir->file_header.type == FILEOBJ_NONE)
+                return FR_NO_PATH;
+            min_pos = _index_log_pos(dir->file_addr) + 1;
+        }
+        int next_addr = -1, next_pos = 0;
+        for (int i = 0; i < _index.size; i++) {
+            struct index_entry *e = &_index.entry[i];
+            if (! e->addr || e->parent_dir != dir->parent_dir)
+                continue;
+            int pos = _index_log_pos(e->addr);
+            if (pos >= min_pos && (next_addr == -1 || pos < next_pos)) {
+                next_addr = e->addr;
+                next_pos = pos;
+            }
+        }
+        if (next_addr == -1) {
+            dir->file_header.type = FILEOBJ_NONE;
+            return FR_NO_PATH;
+        }
+        dir->file_addr = next_addr;
+        _spiread(&dir->file_header, dir->file_addr, sizeof(struct file_header));
+        _fill_fileinfo(dir, fi);
+        return FR_OK;
+    }
     if (dir->file_cur_pos == -1) {
         //Start at the beginning
-        dir->file_addr = dir->start_sector * SECTOR_SIZE + 1; //reset current position
+        dir->file_addr = _log_start(); //reset current position
         dir->file_cur_pos = 0;
     } else {
         if (dir->file_header.type == FILEOBJ_NONE)
@@ -408,7 +884,7 @@ FRESULT df_readdir (DIR *dir, FILINFO *fi)
     }
     _spiread(&dir->file_header, dir->file_addr, sizeof(struct file_header));
     while (dir->file_header.type != FILEOBJ_NONE) {
-        if (! FILE_DELETED(dir->file_header) && dir->file_header.parent_dir == dir->parent_dir) {
+        if (FILE_LIVE(dir->file_header) && dir->file_header.parent_dir == dir->parent_dir) {
             _fill_fileinfo(dir, fi);
             return FR_OK;
         }
@@ -418,37 +894,29 @@ FRESULT df_readdir (DIR *dir, FILINFO *fi)
     return FR_NO_PATH;
 }
 
-int _get_next_write_addr()
-{
-    struct file_header fh = _fs->file_header;
-    int addr = _fs->file_addr;
-    while(fh.type != FILEOBJ_NONE) {
-        addr = _get_addr(addr, sizeof(struct file_header) + FILE_SIZE(fh));
-        _spiread(&fh, addr, sizeof(struct file_header));
-    }
-    return addr;
-}
-
 int _get_free_space()
 {
-    // This assues _fs->file_addr is already at the next writeable location
-    int delta = _fs->compact_sector - (1 + (_fs->file_addr / SECTOR_SIZE)); //# sectors from next boundary to the compact_sector
+    // Space between the end of the log and the compact_sector
+    if (_log.end / SECTOR_SIZE == _mountfs->compact_sector)
+        return 0;
+    int delta = _mountfs->compact_sector - (1 + (_log.end / SECTOR_SIZE)); //# sectors from next boundary to the compact_sector
     if (delta < 0)
         delta += SECTOR_COUNT;
     delta = delta * (SECTOR_SIZE - 1);
-    delta += SECTOR_SIZE - (_fs->file_addr % SECTOR_SIZE);
+    delta += SECTOR_SIZE - (_log.end % SECTOR_SIZE);
     return delta - 1;
 }
     
 void _create_empty_file(int delete_first)
 {
     //Delete file 1st
-    u8 data[BUF_SIZE];
     if (delete_first) {
-        data[0] = FILEOBJ_FILEDEL;
-        disk_writep_rand(data, _fs->file_addr / SECTOR_SIZE, _fs->file_addr % SECTOR_SIZE, 1);
-        _fs->file_addr = _get_next_write_addr();
+        u8 type = FILEOBJ_FILEDEL;
+        disk_writep_rand(&type, _fs->file_addr / SECTOR_SIZE, _fs->file_addr % SECTOR_SIZE, 1);
+        _index_remove(_fs->file_addr);
+        _log.reclaim += sizeof(struct file_header) + FILE_SIZE(_fs->file_header);
     }
+    _fs->file_addr = _log.end;
 
     unsigned cur_size = FILE_SIZE(_fs->file_header);
     if (cur_size == 0 ) //we need to make sure max_size is non-zero
@@ -457,20 +925,17 @@ void _create_empty_file(int delete_first)
     if (requested_size < MINIMUM_NEW_FILE_SIZE)
         requested_size = MINIMUM_NEW_FILE_SIZE;
     unsigned max_size = _get_free_space();
-    if (requested_size > max_size)
-        max_size = requested_size;
-    //Max size is total space available, we need to subtract the file_header
-    if (max_size - cur_size > sizeof(struct file_header))
-        max_size -= sizeof(struct file_header);
-    
-    int end_addr = _get_addr(_fs->file_addr, sizeof(struct file_header) + max_size);
-    //Check whether end_addr is past the compact_sector
-    if (end_addr > _fs->compact_sector*SECTOR_SIZE || (end_addr < _fs->file_addr && _fs->file_addr <= _fs->compact_sector*SECTOR_SIZE)) {
+    if (requested_size > max_size) {
         //file won't fit.  need to compact
-        df_compact();
+        _compact_all(requested_size);
+        _fs->file_addr = _log.end;
         max_size = _get_free_space();
         //printf("Compacting: New max size: %d\n", max_size);
     }
+    //Max size is total space available, we need to subtract the file_header
+    if (max_size > sizeof(struct file_header))
+        max_size -= sizeof(struct file_header);
+    
     //duplicate file header to new location
     //zero file size (we'll write the actual size at close
     if(_fs->file_header.type != FILEOBJ_DIR) {
@@ -478,6 +943,7 @@ void _create_empty_file(int delete_first)
         _fs->file_header.size2 = 0; 
         _fs->file_header.size3 = 0; 
         _spiwrite(&_fs->file_header, _fs->file_addr, sizeof(struct file_header));
+        _index_add(&_fs->file_header, _fs->file_addr);
         //place the maximum allocated filesize as a place-holder
         _fs->file_header.size1 = 0xff & (max_size >> 16);
         _fs->file_header.size2 = 0xff & (max_size >> 8);
@@ -486,7 +952,9 @@ void _create_empty_file(int delete_first)
         _fs->file_cur_pos = 0;
     } else {
         _spiwrite(&_fs->file_header, _fs->file_addr, sizeof(struct file_header));
+        _index_add(&_fs->file_header, _fs->file_addr);
     }
+    _log.end = _get_addr(_fs->file_addr, sizeof(struct file_header));
 }
 
 FRESULT df_unlink(const char *name)
@@ -498,8 +966,10 @@ FRESULT df_unlink(const char *name)
     res = _find_file(_fs, cur_dir);
     if (res == 0) {
         u8 data[2];
+        _log.reclaim += sizeof(struct file_header) + FILE_SIZE(_fs->file_header);
         data[0] = _fs->file_header.type |= FILEOBJ_DELMASK;
         disk_writep_rand(data, _fs->file_addr / SECTOR_SIZE, _fs->file_addr % SECTOR_SIZE, 1);
+        _index_remove(_fs->file_addr);
         return FR_OK;
     }
     return FR_NO_FILE;
@@ -507,26 +977,23 @@ FRESULT df_unlink(const char *name)
 
 void _create_file_or_dir(char *fname, int type)
 {
-    // Need to initialzie addr and read 1st item for get_next_write_addr
-    _fs->file_addr = _fs->start_sector * SECTOR_SIZE + 1; //reset current position
-    _spiread(&_fs->file_header, _fs->file_addr, sizeof(struct file_header));
-    if (type == AM_FILE) {
-        _fs->file_addr = _get_next_write_addr();
-        _fs->file_header.type = FILEOBJ_FILE;
-    } else {
+    memset(&_fs->file_header, 0, sizeof(struct file_header));
+    if (type == AM_DIR) {
         int id;
         int i;
         unsigned char seen_dir[8];
-        struct file_header fh = _fs->file_header;
+        struct file_header fh;
+        int addr = _log_start();
         memset(seen_dir, 0, 8);
         seen_dir[0] = 1;
+        _spiread(&fh, addr, sizeof(struct file_header));
         while(fh.type != FILEOBJ_NONE) {
             if (fh.type == FILEOBJ_DIR) {
                 id = FILE_ID(fh);
                 seen_dir[id / 8] |= 1 << (id % 8);
             }
-            _fs->file_addr = _get_addr(_fs->file_addr, sizeof(struct file_header) + FILE_SIZE(fh));
-            _spiread(&fh, _fs->file_addr, sizeof(struct file_header));
+            addr = _get_addr(addr, sizeof(struct file_header) + FILE_SIZE(fh));
+            _spiread(&fh, addr, sizeof(struct file_header));
         }
         for(i = 0; i < 256; i++) {
             if((seen_dir[i/8] & (1 << (i % 8))) == 0)
@@ -595,6 +1062,9 @@ FRESULT df_close ()
         _fs->file_header.size2 = 0xff & (_fs->file_cur_pos >> 8);
         _fs->file_header.size3 = 0xff & (_fs->file_cur_pos >> 0);
         _spiwrite(&_fs->file_header.size1, _get_addr(_fs->file_addr, offsetof(struct file_header, size1)), 3);
+        _log.end = _get_addr(_fs->file_addr, sizeof(struct file_header) + _fs->file_cur_pos);
+        if ((int)sizeof(struct file_header) + _fs->file_cur_pos > _log.largest)
+            _log.largest = sizeof(struct file_header) + _fs->file_cur_pos;
     }
     _fs->file_cur_pos = -1;
     return FR_OK;
@@ -643,6 +1113,15 @@ FRESULT df_write (const void *buffer, u16 requested, u16 *written)
         //printf(" to %d\n", requested);
     } 
     _spiwrite(buffer, _get_addr(_fs->file_addr, sizeof(struct file_header) + _fs->file_cur_pos), requested);
+#if DEVOFS_BACKGROUND_COMPACT
+    if (_log.copy_to && _fs->file_addr == _log.read && _fs->file_cur_pos < _log.copy_pos) {
+        //A file written in place (datalog.bin) is being copied:  the part already copied needs the data too
+        int len = _log.copy_pos - _fs->file_cur_pos;
+        if (len > requested)
+            len = requested;
+        _spiwrite(buffer, _get_addr(_log.copy_to, sizeof(struct file_header) + _fs->file_cur_pos), len);
+    }
+#endif
     _fs->file_cur_pos += requested;
     *written = requested;
     return FR_OK;  
@@ -663,3 +1142,6 @@ FRESULT df_switchfile (FATFS *fs)
 }
 
 FRESULT df_maximize_file_size() { return FR_OK; }
+
+#define TESTNAME devofs
+#include <tests.h>
@@ -35,6 +35,12 @@ struct file_header {
     u8 size3;
 };
 
+struct index_entry {
+    u16 addr;
+    u16 key;
+    u8 parent_dir;
+};
+
 typedef struct FATFS_s{
     int start_sector;
     int compact_sector;
@@ -53,6 +59,7 @@ typedef struct {
         char    fname[13];      /* File name */
 } FILINFO;
 
+void df_set_index (struct index_entry*, unsigned);	/* RAM file index for the next mount (power of 2 entries) */
 FRESULT df_mount (FATFS*);			/* Mount/Unmount a logical drive */
 FRESULT df_add_file_descriptor (FATFS *);
 FRESULT df_switchfile (FATFS *);
@@ -68,3 +75,4 @@ FRESULT df_mkdir(const char *name);
 FRESULT df_unlink(const char *name);
 FRESULT df_stat(FILINFO *fi);
 FRESULT df_compact ();
+int df_compact_step ();			/* Reclaim deleted space a little at a time */
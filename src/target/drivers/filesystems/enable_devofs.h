@@ -9,7 +9,18 @@
     } DRIVE;
     #define FSHANDLE FATFS
 
-    #define fs_mount      df_mount
+    //Files and directories held in the RAM index (power of 2, 0 to always scan the flash)
+    #ifndef DEVOFS_INDEX_SIZE
+        #define DEVOFS_INDEX_SIZE 64
+    #endif
+    static inline FRESULT fs_mount(FATFS *fs)
+    {
+    #if DEVOFS_INDEX_SIZE
+        static struct index_entry entry[DEVOFS_INDEX_SIZE];  //only FS_Mount() mounts devofs
+        df_set_index(entry, DEVOFS_INDEX_SIZE);
+    #endif
+        return df_mount(fs);
+    }
     #define fs_open(ptr, path, flags, mode)   df_open(path, flags)
     #define fs_read(r, ptr, len, br)          df_read(ptr, len, (u16 *)(br))
     #define fs_lseek(r, ptr)                  df_lseek(ptr)
@@ -25,6 +36,7 @@
     #define fs_filesize(x)                    (((x)->file_header.size1 << 8) | (x)->file_header.size2)
     #define fs_ltell(x)                       ((x)->file_cur_pos)
     #define fs_is_initialized(x)              (((FATFS *)(x))->start_sector != ((FATFS *)(x))->compact_sector)
+    #define fs_background()                   df_compact_step()
     static inline void fs_init(FSHANDLE * fh, const char *drive)
     {
         (void)drive;
@@ -26,7 +26,11 @@ static const struct {
 	void (*EraseSector)(u32 sectorAddress);
 	long SECTOR_OFFSET;
 } drive[] = {
+#if STORAGE_CACHE_LINES
+    { STORAGE_CacheReadBytes, STORAGE_CacheReadBytesStopCR, STORAGE_CacheWriteBytes, STORAGE_CacheEraseSector, SPIFLASH_SECTOR_OFFSET },
+#else
     { STORAGE_ReadBytes, STORAGE_ReadBytesStopCR, STORAGE_WriteBytes, STORAGE_EraseSector, SPIFLASH_SECTOR_OFFSET },
+#endif
 #ifdef MEDIA_DRIVE
     { MEDIA_DRIVE },
 #endif
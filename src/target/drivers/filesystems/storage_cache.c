@@ -0,0 +1,202 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "common.h"
+
+#if STORAGE_CACHE_LINES
+/* Read cache and write coalescing between petit_fat/devofs and the storage
+ * driver.
+ * Reads are served from STORAGE_CACHE_LINES lines of one flash page each,
+ * replaced least recently used first.  A miss that continues the previous
+ * read also fetches the next line of the same sector.  Whole lines of large
+ * reads (image data, USB) bypass the cache so they don't evict the small
+ * config/font/language reads that are repeated on every page change.
+ * Contiguous writes to one page are collected and programmed together when
+ * the write moves to another page, on any access to that page, before any
+ * erase, on close and on STORAGE_CacheFlush().  Written or erased lines are dropped rather than
+ * patched, since how a program over existing data reads back depends on the
+ * storage type */
+#define LINE_SIZE         256      // flash program page
+#define FLASH_SECTOR_SIZE 0x1000
+#define READAHEAD         2        // lines fetched on a sequential miss
+
+struct cache_line {
+    u32 addr;
+    u32 used;           // 0 if the line is empty
+    u8 data[LINE_SIZE];
+};
+
+static struct {
+    struct cache_line line[STORAGE_CACHE_LINES];
+    u32 tick;
+    u32 next_read;      // address following the last read
+    u32 wb_addr;        // first pending byte
+    u16 wb_len;         // 0 if nothing is pending
+    u8 wb_data[LINE_SIZE];
+} cache;
+
+static void invalidate(u32 start, u32 end)
+{
+    for (int i = 0; i < STORAGE_CACHE_LINES; i++) {
+        struct cache_line *l = &cache.line[i];
+        if (l->used && l->addr < end && l->addr + LINE_SIZE > start)
+            l->used = 0;
+    }
+}
+
+void STORAGE_CacheFlush()
+{
+    if (! cache.wb_len)
+        return;
+    STORAGE_WriteBytes(cache.wb_addr, cache.wb_len, cache.wb_data);
+    cache.wb_len = 0;
+}
+
+void STORAGE_CacheReset()
+{
+    STORAGE_CacheFlush();
+    for (int i = 0; i < STORAGE_CACHE_LINES; i++)
+        cache.line[i].used = 0;
+}
+
+static void flush_overlap(u32 start, u32 end)
+{
+    if (cache.wb_len && cache.wb_addr < end && cache.wb_addr + cache.wb_len > start)
+        STORAGE_CacheFlush();
+}
+
+static struct cache_line *find_line(u32 addr)
+{
+    for (int i = 0; i < STORAGE_CACHE_LINES; i++) {
+        if (cache.line[i].used && cache.line[i].addr == addr)
+            return &cache.line[i];
+    }
+    return NULL;
+}
+
+static struct cache_line *fill_line(u32 addr, u32 used)
+{
+    struct cache_line *victim = &cache.line[0];
+    for (int i = 1; i < STORAGE_CACHE_LINES && victim->used; i++) {
+        if (cache.line[i].used < victim->used)
+            victim = &cache.line[i];
+    }
+    flush_overlap(addr, addr + LINE_SIZE);
+    STORAGE_ReadBytes(addr, LINE_SIZE, victim->data);
+    victim->addr = addr;
+    victim->used = used;
+    return victim;
+}
+
+static struct cache_line *get_line(u32 addr, int sequential)
+{
+    struct cache_line *l = find_line(addr);
+    cache.tick++;
+    if (l) {
+        l->used = cache.tick;
+        return l;
+    }
+    if (sequential && STORAGE_CACHE_LINES > READAHEAD) {
+        // Read-ahead stays within the sector so it never runs off the end of the storage
+        for (int i = 1; i < READAHEAD; i++) {
+            u32 next = addr + i * LINE_SIZE;
+            if (next % FLASH_SECTOR_SIZE == 0)
+                break;
+            if (! find_line(next))
+                fill_line(next, cache.tick);
+        }
+    }
+    return fill_line(addr, ++cache.tick);
+}
+
+/* Copies up to len bytes, stopping after a '\n' if stop_cr is set */
+static u32 cached_read(u32 addr, u32 len, u8 *buffer, int stop_cr)
+{
+    int sequential = (addr == cache.next_read);
+    int large = ! stop_cr && len >= 2 * LINE_SIZE;
+    u32 done = 0;
+    while (done < len) {
+        u32 line_addr = (addr + done) & ~(LINE_SIZE - 1);
+        u32 offset = addr + done - line_addr;
+        u32 count = LINE_SIZE - offset;
+        if (count > len - done)
+            count = len - done;
+        if (large && count == LINE_SIZE && ! find_line(line_addr)) {
+            flush_overlap(line_addr, line_addr + LINE_SIZE);
+            STORAGE_ReadBytes(line_addr, LINE_SIZE, buffer + done);
+            done += LINE_SIZE;
+            continue;
+        }
+        const u8 *src = get_line(line_addr, sequential)->data + offset;
+        if (stop_cr) {
+            const u8 *cr = memchr(src, '\n', count);
+            if (cr) {
+                count = cr - src + 1;
+                len = done + count;
+            }
+        }
+        memcpy(buffer + done, src, count);
+        done += count;
+        sequential = 1;
+    }
+    cache.next_read = addr + done;
+    return done;
+}
+
+void STORAGE_CacheReadBytes(u32 readAddress, u32 length, u8 *buffer)
+{
+    cached_read(readAddress, length, buffer, 0);
+}
+
+int STORAGE_CacheReadBytesStopCR(u32 readAddress, u32 length, u8 *buffer)
+{
+    return cached_read(readAddress, length, buffer, 1);
+}
+
+void STORAGE_CacheWriteBytes(u32 writeAddress, u32 length, const u8 *buffer)
+{
+    invalidate(writeAddress, writeAddress + length);
+    while (length) {
+        u32 count = LINE_SIZE - (writeAddress % LINE_SIZE);
+        if (count > length)
+            count = length;
+        if (! cache.wb_len || writeAddress != cache.wb_addr + cache.wb_len
+            || writeAddress % LINE_SIZE == 0)
+        {
+            // Not a continuation of the pending write within the same page
+            STORAGE_CacheFlush();
+            cache.wb_addr = writeAddress;
+            cache.wb_len = 0;
+        }
+        memcpy(cache.wb_data + cache.wb_len, buffer, count);
+        cache.wb_len += count;
+        writeAddress += count;
+        buffer += count;
+        length -= count;
+    }
+}
+
+void STORAGE_CacheEraseSector(u32 sectorAddress)
+{
+    if (cache.wb_len && cache.wb_addr / FLASH_SECTOR_SIZE == sectorAddress / FLASH_SECTOR_SIZE)
+        cache.wb_len = 0;   // About to be erased anyway
+    else
+        STORAGE_CacheFlush();  // Program before erasing, as issued:  devofs relies on the order to survive a power cut
+    invalidate(sectorAddress, sectorAddress + FLASH_SECTOR_SIZE);
+    STORAGE_EraseSector(sectorAddress);
+}
+
+#define TESTNAME storage_cache
+#include <tests.h>
+#endif  // STORAGE_CACHE_LINES
@@ -163,6 +163,9 @@ intptr_t _open_r(FSHANDLE *r, const char *file, int flags, int mode) {
 int _close_r(FSHANDLE *r) {
     if(r) {
        int res = fs_close(r);
+#if STORAGE_CACHE_LINES
+       STORAGE_CacheFlush();
+#endif
        dbgprintf("_close_r(%08lx): ret (%d) file_still_open: %08lx.\r\n", r, res, fs_is_open(r));
     }
     return 0;
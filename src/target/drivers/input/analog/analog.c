@@ -176,16 +176,22 @@ void ADC_StartCapture()
     ADC_start_conversion(ADC_CFG.adc);
 }
 
+/* The DMA refills adc_array_oversample several times between mixer updates,
+ * so each call averages the whole buffer, walking it once in DMA order */
 void ADC_Filter()
 {
+    u32 sum[NUM_ADC_CHANNELS];
+    const volatile u16 *sample = adc_array_oversample;
+    for (int i = 0; i < NUM_ADC_CHANNELS; i++)
+        sum[i] = 0;
+    for (int j = 0; j < WINDOW_SIZE * ADC_OVERSAMPLE_WINDOW_COUNT; j++) {
+        for (int i = 0; i < NUM_ADC_CHANNELS; i++)
+            sum[i] += *sample++;
+    }
     for (int i = 0; i < NUM_ADC_CHANNELS; i++) {
-        u32 result = 0;
-        int idx = i;
-        for(int j = 0; j < WINDOW_SIZE * ADC_OVERSAMPLE_WINDOW_COUNT; j++) {
-            result += adc_array_oversample[idx];
-            idx += NUM_ADC_CHANNELS;
-        }
-        result /= ADC_OVERSAMPLE_WINDOW_COUNT * WINDOW_SIZE;
+        u32 result = sum[i] / (ADC_OVERSAMPLE_WINDOW_COUNT * WINDOW_SIZE);
+        if (i < INP_HAS_CALIBRATION)
+            result = CHAN_FilterInput(i + 1, result);
         adc_array_raw[i] = result;
     }
 }
@@ -199,33 +205,12 @@ s32 ADC_ReadRawInput(int channel)
 
 s32 ADC_NormalizeChannel(int channel)
 {
-    s32 value = ADC_ReadRawInput(channel);
-    s32 max = Transmitter.calibration[channel - 1].max;
-    s32 min = Transmitter.calibration[channel - 1].min;
-    s32 zero = Transmitter.calibration[channel - 1].zero;
-    if (!zero) {
-        // If this input doesn't have a zero, calculate from max/min
-        zero = ((u32)max + min) / 2;
-    }
-    // Derate min and max by 1% to ensure we can get all the way to 100%
-    max = (max - zero) * 99 / 100;
-    min = (min - zero) * 99 / 100;
-    if (value >= zero) {
-        value = (value - zero) * CHAN_MAX_VALUE / max;
-    } else {
-        value = (value - zero) * CHAN_MIN_VALUE / min;
-    }
-    // Bound output
-    if (value > CHAN_MAX_VALUE)
-        value = CHAN_MAX_VALUE;
-    if (value < CHAN_MIN_VALUE)
-        value = CHAN_MIN_VALUE;
+    s32 value = CHAN_ScaleInput(channel, ADC_ReadRawInput(channel));
 
     #define ADC_CHAN(x, y, z) (z)
-    const s8 chan_inverted[NUM_ADC_CHANNELS] = ADC_CHANNELS;
+    static const s8 chan_inverted[NUM_ADC_CHANNELS] = ADC_CHANNELS;
     #undef ADC_CHAN
-    value = value * chan_inverted[channel - 1];
-    return value;
+    return chan_inverted[channel - 1] < 0 ? -value : value;
 }
 
 void ADC_ScanChannels()
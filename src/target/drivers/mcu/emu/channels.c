@@ -15,6 +15,7 @@
 #include "common.h"
 #include "target/drivers/mcu/emu/fltk.h"
 #include "mixer.h"
+#include "config/tx.h"
 
 #define KEY_INP_SWA gui.rud_dr
 #define KEY_INP_SWB gui.ele_dr
@@ -34,7 +35,7 @@
 #define KEY_INP_TRN       gui.trn
 #define KEY_INP_DR        gui.dr
 
-s32 ADC_ReadRawInput(int channel)
+static s32 gui_input(int channel)
 {
     s32 step = (CHAN_MAX_VALUE - CHAN_MIN_VALUE) / 10;
     switch (channel) {
@@ -54,6 +55,24 @@ s32 ADC_ReadRawInput(int channel)
     return 0;
 }
 
+/* Mirrors the hardware ADC_Filter: the filter stage sees one new reading per
+ * mixer update.  The inputs are already in channel units so there is no
+ * calibration to apply */
+static s32 adc_filtered[INP_HAS_CALIBRATION];
+
+void ADC_Filter()
+{
+    for (int i = 0; i < INP_HAS_CALIBRATION; i++)
+        adc_filtered[i] = CHAN_FilterInput(i + 1, gui_input(i + 1));
+}
+
+s32 ADC_ReadRawInput(int channel)
+{
+    if (channel > 0 && channel <= INP_HAS_CALIBRATION && Transmitter.calibration[channel - 1].filter)
+        return adc_filtered[channel - 1];
+    return gui_input(channel);
+}
+
 s32 ADC_NormalizeChannel(int channel)
 {
     return ADC_ReadRawInput(channel);
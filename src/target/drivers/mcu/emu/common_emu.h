@@ -7,6 +7,8 @@
 
 #define TARGET_PRIORITY \
     TIMER_ENABLE
+
+#define CRC_TABLE_BITS 8  // flash is not a concern on the host
 //This is a trick to only enable this function in the emu and to use an inline version for devo
 #define LCD_ForceUpdate LCD_ForceUpdate
 #endif
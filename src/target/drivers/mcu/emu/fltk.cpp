@@ -37,6 +37,8 @@
 
 bool changed = false;
 static bool singlethread = false;
+static bool virtualtime = false;
+static bool headless = false;
 
 #define USE_OWN_PRINTF 0 //Disable sprintf mappingdue to need for %f
 //Windows
@@ -49,6 +51,7 @@ extern "C" {
 #include "mixer.h"
 #include "config/tx.h"
 #include "buttonmap.h"
+#include "radio_sim.h"
 }
 
 #ifdef LCD_EMU_LOWLEVEL
@@ -369,6 +372,15 @@ extern void _lcd_init();
 void LCD_Init()
 {
   int i;
+  if (headless) {
+      memset(&gui, 0, sizeof(gui));
+      gui.last_redraw = CLOCK_getms();
+      gui.init = 1;
+#ifdef HAS_LCD_INIT
+      _lcd_init();
+#endif
+      return;
+  }
   Fl::visual(FL_RGB);
   // 85 is for 4 rows' height
   int lcdScreenWidth = SCREEN_X;
@@ -452,8 +464,10 @@ void LCD_DrawStart(unsigned int x0, unsigned int y0, unsigned int x1, unsigned i
         gui.dir = -1;
     }
 #ifndef HAS_EVENT_LOOP
-    Fl::check();
-    Fl::flush();
+    if (main_window) {
+        Fl::check();
+        Fl::flush();
+    }
 #endif
 }
 
@@ -483,7 +497,8 @@ u32 ScanButtons()
 
 int PWR_CheckPowerSwitch()
 {
-    Fl::check();
+    if (main_window)
+        Fl::check();
     return gui.powerdown;
 }
 
@@ -502,28 +517,36 @@ void SPITouch_Calibrate(s32 xscale, s32 yscale, s32 xoff, s32 yoff)
     calibration.yoffset = yoff;
 }
 
-//  bug fix: msecs should be removed as Windows can't guarantee every type of Windows can set timer as short as 1ms
-//u32 msecs = 0;
-u32 msec_cbtime[NUM_MSEC_CALLBACKS];
+/* Callback deadlines are kept in microseconds so that protocol callbacks
+ * returning sub-millisecond periods are scheduled correctly.
+ * With VIRTUALTIME set in the environment, the firmware clock is simulated:
+ * whenever the main loop goes idle the clock jumps straight to the next
+ * pending deadline.  Runs are deterministic and faster than real time.
+ * VIRTUALTIME=<ms> stops the emulator once the virtual clock reaches <ms>.
+ * With HEADLESS set no window is opened, so together with EMU_SCRIPT (below)
+ * a run needs no display or user. */
+#define VIRTUAL_POLL_LIMIT 1000
+static u64 cbtime_us[NUM_MSEC_CALLBACKS];
+static u64 virtual_us;
+static u64 virtual_end_us;
+static unsigned virtual_polls;
+static bool in_callback;
 u8 timer_enable;
-void ALARMhandler()
+
+static u64 clock_us()
 {
-    /* msecs++;
-    if(msecs % 1000 == 0) printf("msecs %d\n", msecs);
-    if(msecs%200==0)
-    {   // In my PC, every 200 count = 1 second, so 1 unit of msecs = 5ms, which is the minimum time unit
-        // so the msecs doesn't work in Windows
-        struct timeb tp;
-        u32 t;
-        ftime(&tp);
-        t = (tp.time * 1000) + tp.millitm;
-        printf("%d\n",t);
-    } */
-
-    if(timer_callback && timer_enable & (1 << TIMER_ENABLE) &&
-            CLOCK_getms() >= msec_cbtime[TIMER_ENABLE])
-            //msecs == msec_cbtime[TIMER_ENABLE])
-    {
+    if (virtualtime)
+        return virtual_us;
+    struct timeval tp;
+    gettimeofday(&tp, NULL);
+    return (u64)tp.tv_sec * 1000000 + tp.tv_usec;
+}
+
+static void run_callback(int cb)
+{
+    in_callback = true;
+    switch(cb) {
+    case TIMER_ENABLE: {
 #ifdef TIMING_DEBUG
         debug_timing(4, 0);
 #endif
@@ -531,24 +554,152 @@ void ALARMhandler()
 #ifdef TIMING_DEBUG
         debug_timing(4, 1);
 #endif
+        //Like the hardware timer, a 0 return stops the protocol timer
         if (us > 0) {
-            msec_cbtime[TIMER_ENABLE] += us;
+            cbtime_us[TIMER_ENABLE] += us;
+        } else {
+            timer_enable &= ~(1 << TIMER_ENABLE);
         }
+        break;
     }
-    if(timer_enable & (1 << MEDIUM_PRIORITY) &&
-            CLOCK_getms() >= msec_cbtime[MEDIUM_PRIORITY])
-            // msecs == msec_cbtime[MEDIUM_PRIORITY])
-    {
+    case MEDIUM_PRIORITY:
+        ADC_Filter();
         MIXER_CalcChannels();
         priority_ready |= 1 << MEDIUM_PRIORITY;
-        msec_cbtime[MEDIUM_PRIORITY] += MEDIUM_PRIORITY_MSEC;
-    }
-    if(timer_enable & (1 << LOW_PRIORITY) &&
-            CLOCK_getms() >= msec_cbtime[LOW_PRIORITY])
-            // msecs == msec_cbtime[LOW_PRIORITY])
-    {
+        cbtime_us[MEDIUM_PRIORITY] += MEDIUM_PRIORITY_MSEC * 1000;
+        break;
+    case LOW_PRIORITY:
         priority_ready |= 1 << LOW_PRIORITY;
-        msec_cbtime[LOW_PRIORITY] += LOW_PRIORITY_MSEC;
+        cbtime_us[LOW_PRIORITY] += LOW_PRIORITY_MSEC * 1000;
+        break;
+    }
+    in_callback = false;
+}
+
+//Callbacks due at the same time run in this order
+static const u8 callback_order[] = {TIMER_ENABLE, MEDIUM_PRIORITY, LOW_PRIORITY};
+
+static int callback_enabled(int cb)
+{
+    if (cb == TIMER_ENABLE && ! timer_callback)
+        return 0;
+    return timer_enable & (1 << cb);
+}
+
+void ALARMhandler()
+{
+    u64 now = clock_us();
+    for (unsigned i = 0; i < sizeof(callback_order); i++) {
+        int cb = callback_order[i];
+        if (callback_enabled(cb) && now >= cbtime_us[cb])
+            run_callback(cb);
+    }
+}
+
+/* Advance the virtual clock to the earliest pending deadline and run it */
+static void virtual_step()
+{
+    int next = -1;
+    for (unsigned i = 0; i < sizeof(callback_order); i++) {
+        int cb = callback_order[i];
+        if (callback_enabled(cb) && (next < 0 || cbtime_us[cb] < cbtime_us[next]))
+            next = cb;
+    }
+    if (next < 0) {
+        virtual_us += 1000;
+    } else if (cbtime_us[next] > virtual_us) {
+        virtual_us = cbtime_us[next];
+    }
+    if (virtual_end_us && virtual_us >= virtual_end_us) {
+        printf("Virtual time limit of %u ms reached\n", (unsigned)(virtual_end_us / 1000));
+        exit(0);
+    }
+    if (next >= 0)
+        run_callback(next);
+}
+
+/* EMU_SCRIPT may name a file of timed inputs, one per line:
+ *     <ms> press <button>       button name as shown in the GUI, e.g. Enter
+ *     <ms> release <button>
+ *     <ms> set <input> <0-10>   throttle, rudder, elevator, aileron, aux2-7,
+ *                               gear, mix, fmod, hold, trn or a dr switch
+ *     <ms> power                power switch off
+ * Each line takes effect once the clock reaches <ms> */
+struct script_event {
+    u32 ms;
+    char cmd[8];
+    char arg[16];
+    int value;
+};
+static struct script_event *script;
+static unsigned script_len;
+static unsigned script_pos;
+
+static void load_script()
+{
+    const char *path = getenv("EMU_SCRIPT");
+    FILE *fh = path ? fopen(path, "r") : NULL;
+    if (! fh)
+        return;
+    char line[128];
+    while (fgets(line, sizeof(line), fh)) {
+        struct script_event ev;
+        memset(&ev, 0, sizeof(ev));
+        if (line[0] == '#' || sscanf(line, "%u %7s %15s %d", &ev.ms, ev.cmd, ev.arg, &ev.value) < 2)
+            continue;
+        script = (struct script_event *)realloc(script, (script_len + 1) * sizeof(*script));
+        script[script_len++] = ev;
+    }
+    fclose(fh);
+}
+
+static int *script_input(const char *name)
+{
+    static const struct {
+        const char *name;
+        int *value;
+    } inputs[] = {
+        {"throttle", &gui.throttle}, {"rudder", &gui.rudder},
+        {"elevator", &gui.elevator}, {"aileron", &gui.aileron},
+        {"aux2", &gui.aux2}, {"aux3", &gui.aux3}, {"aux4", &gui.aux4},
+        {"aux5", &gui.aux5}, {"aux6", &gui.aux6}, {"aux7", &gui.aux7},
+        {"rud_dr", &gui.rud_dr}, {"ail_dr", &gui.ail_dr}, {"ele_dr", &gui.ele_dr},
+        {"dr", &gui.dr}, {"gear", &gui.gear}, {"mix", &gui.mix},
+        {"fmod", &gui.fmod}, {"hold", &gui.hold}, {"trn", &gui.trn},
+    };
+    for (unsigned i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        if (strcasecmp(name, inputs[i].name) == 0)
+            return inputs[i].value;
+    }
+    return NULL;
+}
+
+static int script_button(const char *name)
+{
+    for (int i = 0; keymap[i] != 0; i++) {
+        if (strcasecmp(name, INPUT_ButtonName(i + 1)) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void run_script(u32 ms)
+{
+    for (; script_pos < script_len && script[script_pos].ms <= ms; script_pos++) {
+        const struct script_event *ev = &script[script_pos];
+        int button = script_button(ev->arg);
+        int *input = script_input(ev->arg);
+        if (strcmp(ev->cmd, "press") == 0 && button >= 0) {
+            gui.buttons |= 1 << button;
+        } else if (strcmp(ev->cmd, "release") == 0 && button >= 0) {
+            gui.buttons &= ~(1 << button);
+        } else if (strcmp(ev->cmd, "set") == 0 && input) {
+            *input = ev->value;
+        } else if (strcmp(ev->cmd, "power") == 0) {
+            gui.powerdown = 1;
+        } else {
+            printf("EMU_SCRIPT: can't %s '%s'\n", ev->cmd, ev->arg);
+        }
     }
 }
 
@@ -561,8 +712,13 @@ void _ALARMhandler(int sig) {
 void CLOCK_Init()
 {
     singlethread = getenv("SINGLETHREAD") != NULL;
+    virtualtime = getenv("VIRTUALTIME") != NULL;
+    headless = getenv("HEADLESS") != NULL;
+    if (virtualtime)
+        virtual_end_us = strtoull(getenv("VIRTUALTIME"), NULL, 10) * 1000;
+    load_script();
 
-    if (singlethread)
+    if (singlethread || virtualtime)
         return;
 
     timer_callback = NULL;
@@ -627,8 +783,7 @@ void CLOCK_Init()
 void CLOCK_StartTimer(unsigned us, u16 (*cb)(void))
 {
     timer_callback = cb;
-    msec_cbtime[TIMER_ENABLE] = CLOCK_getms() + us;
-            // msecs + us;
+    cbtime_us[TIMER_ENABLE] = clock_us() + us;
     timer_enable |= 1 << TIMER_ENABLE;
 }
 
@@ -638,8 +793,7 @@ void CLOCK_StopTimer()
 }
 void CLOCK_SetMsecCallback(int cb, u32 msec)
 {
-    msec_cbtime[cb] = CLOCK_getms() + msec;
-            //msecs + msec;
+    cbtime_us[cb] = clock_us() + (u64)msec * 1000;
     timer_enable |= 1 << cb;
 }
 void CLOCK_ClearMsecCallback(int cb)
@@ -652,20 +806,40 @@ volatile mixsync_t mixer_sync;
 
 u32 CLOCK_getms()
 {
-    struct timeval tp;
-    u32 t;
-    gettimeofday(&tp, NULL);
-    t = (tp.tv_sec * 1000) + (tp.tv_usec / 1000);
-    return t;
+    if (virtualtime && ! in_callback) {
+        //The firmware is busy-waiting on the clock, which would never move
+        if (++virtual_polls > VIRTUAL_POLL_LIMIT) {
+            virtual_polls = 0;
+            virtual_step();
+        }
+    }
+    return clock_us() / 1000;
+}
+
+u64 EMU_ClockUs()
+{
+    return clock_us();
 }
 
 void PWR_Sleep() {
+    run_script(clock_us() / 1000);
+    if (virtualtime) {
+        //Keep the window responsive, then run whatever would have fired
+        //while the main loop slept
+        if (main_window)
+            Fl::check();
+        virtual_polls = 0;
+        do {
+            virtual_step();
+        } while (! priority_ready);
+        return;
+    }
     Fl::wait(0.1);
     if (singlethread)
         ALARMhandler();
 }
 void LCD_ForceUpdate() {
-    if (changed) {
+    if (changed && image) {
         changed = false;
         image->redraw();
         Fl::check();
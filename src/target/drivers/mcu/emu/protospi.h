@@ -1,13 +1,20 @@
 #ifndef _SPIPROTO_H_
 #define _SPIPROTO_H_
 
+#include "target/drivers/mcu/emu/radio_sim.h"
+
 u8 PROTOSPI_read3wire();
+void PROTOSPI_xfer_burst(const u8 *tx, u8 *rx, unsigned len);
+unsigned PROTOSPI_GetCapture(const u8 **data, unsigned *bursts);
+void PROTOSPI_ClearCapture();
 u8 PROTOSPI_xfer(u8 byte);
-#define PROTOSPI_pin_set(io) if (0) {}
-#define PROTOSPI_pin_clear(io) if (0) {}
+#define PROTOSPI_pin_set(io) RADIOSIM_SetCS(&(io), 1)
+#define PROTOSPI_pin_clear(io) RADIOSIM_SetCS(&(io), 0)
 #define _NOP() if(0) {}
 
-#pragma weak A7105_Reset
-#pragma weak CC2500_Reset
-#pragma weak CYRF_Reset
+// Only the chip selects reach the simulator, the JTAG pin used for the AVR
+// reset has no emulated equivalent
+#undef AVR_RESET_PIN
+#define AVR_RESET_PIN ((struct mcu_pin) {0, 0})
+
 #endif // _SPIPROTO_H_
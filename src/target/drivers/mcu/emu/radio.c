@@ -17,6 +17,7 @@
 #include "protocol/interface.h"
 #include "config/model.h"
 #include "config/tx.h"
+#include "protospi.h"
 
 #include <stdlib.h>
 
@@ -123,19 +124,54 @@ int SPI_ProtoGetPinConfig(int module, int state) {
     return 0;
 }
 
-u8 PROTOSPI_read3wire() { return 0x00; }
+u8 PROTOSPI_read3wire() { return RADIOSIM_Read3Wire(); }
 
-u8 PROTOSPI_xfer(u8 byte) { return byte; }
+/* Everything sent to the radio chips is recorded so the drivers can be
+ * checked without hardware, and answered by the chip models in radio_sim.c */
+#define SPI_CAPTURE_SIZE 256
+static u8 spi_capture[SPI_CAPTURE_SIZE];
+static unsigned spi_capture_len;
+static unsigned spi_capture_bursts;
 
-#ifdef PROTO_HAS_A7105
-int A7105_Reset() { return 1; }
-#endif
+static void spi_record(u8 byte)
+{
+    if (spi_capture_len < SPI_CAPTURE_SIZE)
+        spi_capture[spi_capture_len++] = byte;
+}
+
+u8 PROTOSPI_xfer(u8 byte)
+{
+    spi_record(byte);
+    return RADIOSIM_Xfer(byte);
+}
+
+void PROTOSPI_xfer_burst(const u8 *tx, u8 *rx, unsigned len)
+{
+    spi_capture_bursts++;
+    for (unsigned i = 0; i < len; i++) {
+        u8 data = tx ? tx[i] : 0x00;
+        spi_record(data);
+        data = RADIOSIM_Xfer(data);
+        if (rx)
+            rx[i] = data;
+    }
+}
 
-#ifdef PROTO_HAS_CC2500
-int CC2500_Reset() { return 1;}
-#endif //PROTO_HAS_CC2500
-/* CYRF */
-int CYRF_Reset() {return 1;}
+// Returns the number of bytes recorded since the last PROTOSPI_ClearCapture()
+unsigned PROTOSPI_GetCapture(const u8 **data, unsigned *bursts)
+{
+    if (data)
+        *data = spi_capture;
+    if (bursts)
+        *bursts = spi_capture_bursts;
+    return spi_capture_len;
+}
+
+void PROTOSPI_ClearCapture()
+{
+    spi_capture_len = 0;
+    spi_capture_bursts = 0;
+}
 
 void SPI_AVRProgramInit() {}
 void PWM_Initialize() {}
@@ -0,0 +1,632 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "common.h"
+#include "protocol/interface.h"
+#include "config/tx.h"
+#include "radio_sim.h"
+
+/* The models only cover what the drivers in protocol/spi rely on: register
+ * storage, the FIFOs, the commands which start a transmission or a receive
+ * and the status bits the protocols poll.  Transmissions complete instantly
+ * and a receive completes as soon as a scripted response is available. */
+
+#define SIM_CHIPS     MULTIMOD  // CYRF6936, A7105, CC2500, NRF24L01
+#define SIM_FIFO      64
+#define SIM_QUEUE     8
+
+enum {
+    SIM_IDLE = 0,   // values match the CC2500 status byte
+    SIM_RX   = 1,
+    SIM_TX   = 2,
+};
+
+struct sim_chip {
+    u8 regs[0x40];
+    u8 wide[0x40][16];      // registers which take more than one byte
+    u8 tx_fifo[SIM_FIFO];
+    u8 rx_fifo[SIM_FIFO];
+    u8 tx_len;
+    u8 rx_len;
+    u8 rx_pos;
+    u8 state;
+    u8 rx_armed;            // nRF24L01: waiting in RX, deliver on the next poll
+    u8 mode;                // A7105 MODE register
+    // Current SPI transaction
+    u8 count;               // bytes since CS went low (or since an A7105/CC2500 strobe)
+    u8 cmd;
+    u8 addr;
+    u8 wide_pos;
+};
+
+struct sim_response {
+    u8 len;
+    u8 data[SIM_FIFO];
+};
+
+static const char * const chip_name[SIM_CHIPS] = {"cyrf6936", "a7105", "cc2500", "nrf24l01"};
+static const u8 cyrf_mfg_id[6] = {0x4e, 0x61, 0x3c, 0x21, 0x9f, 0x0a};
+
+static struct sim_chip chips[SIM_CHIPS];
+static struct RadioSimStats stats[SIM_CHIPS];
+static struct sim_response queue[SIM_CHIPS][SIM_QUEUE];
+static u8 queue_head[SIM_CHIPS];
+static u8 queue_count[SIM_CHIPS];
+static int selected = -1;
+static int initialized;
+
+static struct sim_response *script;
+static unsigned script_len;
+static u8 *script_chip;
+static unsigned script_pos[SIM_CHIPS];
+static FILE *capture;
+
+extern const u8 xn297_scramble[];
+extern const u16 xn297_crc_xorout[];
+extern const u16 xn297_crc_xorout_scrambled[];
+
+static void load_script()
+{
+    const char *path = getenv("RADIOSIM_SCRIPT");
+    FILE *fh = path ? fopen(path, "r") : NULL;
+    if (! fh)
+        return;
+    char line[512];
+    while (fgets(line, sizeof(line), fh)) {
+        char name[16];
+        int used;
+        if (line[0] == '#' || sscanf(line, "%15s%n", name, &used) != 1)
+            continue;
+        int chip;
+        for (chip = 0; chip < SIM_CHIPS; chip++) {
+            if (strcasecmp(name, chip_name[chip]) == 0)
+                break;
+        }
+        if (chip == SIM_CHIPS) {
+            printf("RADIOSIM: unknown chip '%s' in %s\n", name, path);
+            continue;
+        }
+        script = realloc(script, (script_len + 1) * sizeof(*script));
+        script_chip = realloc(script_chip, script_len + 1);
+        struct sim_response *resp = &script[script_len];
+        const char *ptr = line + used;
+        unsigned byte;
+        int n;
+        resp->len = 0;
+        while (resp->len < SIM_FIFO && sscanf(ptr, "%x%n", &byte, &n) == 1) {
+            resp->data[resp->len++] = byte;
+            ptr += n;
+        }
+        script_chip[script_len++] = chip;
+    }
+    fclose(fh);
+}
+
+static void sim_init()
+{
+    if (initialized)
+        return;
+    initialized = 1;
+    for (int i = 0; i < SIM_CHIPS; i++)
+        RADIOSIM_Reset(i);
+    load_script();
+    const char *path = getenv("RADIOSIM_CAPTURE");
+    if (path) {
+        capture = fopen(path, "w");
+        if (! capture)
+            printf("RADIOSIM: could not open %s\n", path);
+    }
+}
+
+static const struct sim_response *next_response(int chip)
+{
+    if (queue_count[chip]) {
+        const struct sim_response *resp = &queue[chip][queue_head[chip]];
+        queue_head[chip] = (queue_head[chip] + 1) % SIM_QUEUE;
+        queue_count[chip]--;
+        return resp;
+    }
+    while (script_pos[chip] < script_len) {
+        unsigned idx = script_pos[chip]++;
+        if (script_chip[idx] == chip)
+            return &script[idx];
+    }
+    return NULL;
+}
+
+static u8 rev8(u8 b)
+{
+    b = (b & 0xf0) >> 4 | (b & 0x0f) << 4;
+    b = (b & 0xcc) >> 2 | (b & 0x33) << 2;
+    return (b & 0xaa) >> 1 | (b & 0x55) << 1;
+}
+
+/* Undo the XN297 framing the nRF24L01 driver builds:
+ *   [0x55 if addr_len < 4] address (last byte first) payload (bit reversed) crc
+ * with the address and payload optionally scrambled.  Returns the payload
+ * length, or -1 if the crc matches neither the scrambled nor the plain form */
+int RADIOSIM_DecodeXN297(const u8 *packet, unsigned len, unsigned addr_len, u8 *addr, u8 *payload)
+{
+    if (addr_len < 3 || addr_len > 5)
+        return -1;
+    if (addr_len < 4) {
+        if (! len || packet[0] != 0x55)
+            return -1;
+        packet++;
+        len--;
+    }
+    if (len < addr_len + 2 || len - addr_len - 2 + addr_len - 3 > 27)
+        return -1;
+    unsigned plen = len - addr_len - 2;
+    u16 crc = Crc16CcittUpdate(0xb5d2, packet, addr_len + plen);
+    u16 sent = (packet[len - 2] << 8) | packet[len - 1];
+    int scrambled;
+    if ((crc ^ xn297_crc_xorout_scrambled[addr_len - 3 + plen]) == sent)
+        scrambled = 1;
+    else if ((crc ^ xn297_crc_xorout[addr_len - 3 + plen]) == sent)
+        scrambled = 0;
+    else
+        return -1;
+    for (unsigned i = 0; i < addr_len; i++) {
+        unsigned idx = addr_len - 1 - i;
+        addr[i] = packet[idx] ^ (scrambled ? xn297_scramble[idx] : 0);
+    }
+    for (unsigned i = 0; i < plen; i++)
+        payload[i] = rev8(packet[addr_len + i] ^ (scrambled ? xn297_scramble[addr_len + i] : 0));
+    return plen;
+}
+
+static void log_xn297(const struct sim_chip *c, const u8 *data, unsigned len)
+{
+    // The driver puts the XN297 preamble in TX_ADDR
+    static const u8 preamble[] = {0x55, 0x0F, 0x71, 0x0C};
+    unsigned aw = (c->regs[0x03] & 0x03) + 2;
+    if (memcmp(c->wide[0x10], aw < 4 ? preamble + 1 : preamble, 3) != 0)
+        return;
+    u8 addr[5], payload[32];
+    int plen = RADIOSIM_DecodeXN297(data, len, aw, addr, payload);
+    if (plen < 0) {
+        fprintf(capture, " xn297 crc=bad");
+        return;
+    }
+    fprintf(capture, " xn297 addr=");
+    for (unsigned i = 0; i < aw; i++)
+        fprintf(capture, "%02x", addr[i]);
+    fprintf(capture, " payload=");
+    for (int i = 0; i < plen; i++)
+        fprintf(capture, "%02x", payload[i]);
+}
+
+static void log_packet(int chip, int tx, u8 channel, const u8 *data, unsigned len)
+{
+    u64 now = EMU_ClockUs();
+    struct RadioSimStats *s = &stats[chip];
+    if (tx) {
+        if (s->tx_packets) {
+            u32 interval = now - s->last_tx_us;
+            if (interval < s->min_interval_us)
+                s->min_interval_us = interval;
+            if (interval > s->max_interval_us)
+                s->max_interval_us = interval;
+            if (channel != s->channel)
+                s->hops++;
+        } else {
+            s->first_tx_us = now;
+            s->min_interval_us = UINT32_MAX;
+        }
+        s->tx_packets++;
+        s->last_tx_us = now;
+        s->channel = channel;
+        s->last_len = len < sizeof(s->last_packet) ? len : sizeof(s->last_packet);
+        memcpy(s->last_packet, data, s->last_len);
+    } else {
+        s->rx_packets++;
+    }
+    if (! capture)
+        return;
+    // fprintf is tfp_fprintf, which has no 64bit conversions
+    fprintf(capture, "%u.%06u %s %s ch=%d len=%d:", (u32)(now / 1000000), (u32)(now % 1000000),
+            chip_name[chip], tx ? "tx" : "rx", channel, len);
+    for (unsigned i = 0; i < len; i++)
+        fprintf(capture, " %02x", data[i]);
+    if (tx && chip == NRF24L01)
+        log_xn297(&chips[chip], data, len);
+    fprintf(capture, "\n");
+}
+
+static void transmit(int chip, u8 channel)
+{
+    struct sim_chip *c = &chips[chip];
+    log_packet(chip, 1, channel, c->tx_fifo, c->tx_len);
+    c->tx_len = 0;
+}
+
+// Load the next response for this chip into its RX FIFO
+static int receive(int chip, u8 channel)
+{
+    struct sim_chip *c = &chips[chip];
+    const struct sim_response *resp = next_response(chip);
+    if (! resp)
+        return 0;
+    memcpy(c->rx_fifo, resp->data, resp->len);
+    c->rx_len = resp->len;
+    c->rx_pos = 0;
+    log_packet(chip, 0, channel, resp->data, resp->len);
+    return 1;
+}
+
+static u8 rx_pop(struct sim_chip *c)
+{
+    return c->rx_pos < c->rx_len ? c->rx_fifo[c->rx_pos++] : 0;
+}
+
+static void tx_push(struct sim_chip *c, u8 data, unsigned size)
+{
+    if (c->tx_len < size)
+        c->tx_fifo[c->tx_len++] = data;
+}
+
+/* CYRF6936: header bit 7 = write, bit 6 = auto increment */
+static u8 cyrf_xfer(struct sim_chip *c, u8 mosi)
+{
+    if (c->count++ == 0) {
+        c->cmd = mosi & 0xc0;
+        c->addr = mosi & 0x3f;
+        return 0;
+    }
+    u8 addr = c->addr;
+    if (c->cmd & 0x40)
+        c->addr = (c->addr + 1) & 0x3f;
+    if (! (c->cmd & 0x80)) {
+        switch (addr) {
+        case 0x13: return 0x0a;                                 // RSSI
+        case 0x21: return rx_pop(c);                            // RX_BUFFER
+        case 0x22: case 0x23: case 0x24:                        // SOP, data and preamble codes
+            return c->wide[addr][c->wide_pos++ & 0x0f];
+        case 0x25: return cyrf_mfg_id[c->wide_pos++ % 6];       // MFG_ID
+        default:   return c->regs[addr];
+        }
+    }
+    switch (addr) {
+    case 0x02:  // TX_CTRL
+        if (mosi & 0x40)
+            c->tx_len = 0;
+        c->regs[addr] = mosi & 0x3f;
+        if (mosi & 0x80) {
+            if (c->tx_len > c->regs[0x01])
+                c->tx_len = c->regs[0x01];
+            transmit(CYRF6936, c->regs[0x00]);
+            c->regs[0x04] = 0x02;   // TXC
+        }
+        break;
+    case 0x05:  // RX_CTRL
+        c->regs[addr] = mosi & 0x7f;
+        if (mosi & 0x80) {
+            c->regs[0x07] = 0;
+            if (receive(CYRF6936, c->regs[0x00])) {
+                c->regs[0x09] = c->rx_len;
+                c->regs[0x07] = 0x02;   // RXC
+            }
+        }
+        break;
+    case 0x0f:  // XACT_CFG, FRC_END clears itself
+        c->regs[addr] = mosi & ~0x20;
+        break;
+    case 0x1d:  // MODE_OVERRIDE
+        if (mosi & 0x01)
+            RADIOSIM_Reset(CYRF6936);
+        break;
+    case 0x20:  // TX_BUFFER
+        tx_push(c, mosi, 16);
+        break;
+    case 0x22: case 0x23: case 0x24:
+        c->wide[addr][c->wide_pos++ & 0x0f] = mosi;
+        break;
+    default:
+        c->regs[addr] = mosi;
+        break;
+    }
+    return 0;
+}
+
+/* A7105: strobes have bit 7 set, registers use bit 6 for read */
+static u8 a7105_xfer(struct sim_chip *c, u8 mosi)
+{
+    if (c->count == 0) {
+        if (mosi & 0x80) {
+            switch (mosi & 0xf0) {
+            case 0xc0:  // RX
+                c->state = SIM_RX;
+                c->mode = receive(A7105, c->regs[0x0f]) ? 0x00 : 0x01;
+                break;
+            case 0xd0:  // TX
+                transmit(A7105, c->regs[0x0f]);
+                c->state = SIM_IDLE;
+                c->mode = 0;
+                break;
+            case 0xe0: c->tx_len = 0; break;    // RST_WRPTR
+            case 0xf0: c->rx_pos = 0; break;    // RST_RDPTR
+            default:
+                c->state = SIM_IDLE;
+                c->mode = 0;
+                break;
+            }
+            return 0;
+        }
+        c->count = 1;
+        c->cmd = mosi & 0x40;
+        c->addr = mosi & 0x3f;
+        return 0;
+    }
+    if (c->cmd) {
+        switch (c->addr) {
+        case 0x00: return c->mode;
+        case 0x05: return rx_pop(c);
+        case 0x06: return c->wide[0x06][c->wide_pos++ & 0x03];
+        default:   return c->regs[c->addr];
+        }
+    }
+    switch (c->addr) {
+    case 0x00: RADIOSIM_Reset(A7105); break;    // any write resets the chip
+    case 0x05: tx_push(c, mosi, SIM_FIFO); break;
+    case 0x06: c->wide[0x06][c->wide_pos++ & 0x03] = mosi; break;
+    default:   c->regs[c->addr] = mosi; break;
+    }
+    return 0;
+}
+
+/* CC2500: header bit 7 = read, bit 6 = burst.  0x30-0x3d are strobes, or
+ * status registers when read in burst mode */
+static u8 cc2500_status(struct sim_chip *c, int read)
+{
+    unsigned avail = read ? (unsigned)(c->rx_len - c->rx_pos) : (unsigned)(SIM_FIFO - c->tx_len);
+    return (c->state << 4) | (avail > 15 ? 15 : avail);
+}
+
+static u8 cc2500_xfer(struct sim_chip *c, u8 mosi)
+{
+    int read;
+    if (c->count++ == 0) {
+        c->cmd = mosi & 0xc0;
+        c->addr = mosi & 0x3f;
+        read = mosi & 0x80;
+        if (c->addr >= 0x30 && c->addr <= 0x3d && c->cmd != 0xc0) {
+            switch (c->addr) {
+            case 0x30: RADIOSIM_Reset(CC2500); break;              // SRES
+            case 0x34:                                             // SRX
+                c->state = SIM_RX;
+                if (receive(CC2500, c->regs[0x0a]) && (c->regs[0x07] & 0x04)) {
+                    // APPEND_STATUS: RSSI, then CRC_OK and LQI
+                    c->rx_fifo[c->rx_len++] = 0x40;
+                    c->rx_fifo[c->rx_len++] = 0x80 | 0x20;
+                }
+                break;
+            case 0x35:                                             // STX
+                transmit(CC2500, c->regs[0x0a]);
+                c->state = SIM_IDLE;
+                break;
+            case 0x36: c->state = SIM_IDLE; break;                 // SIDLE
+            case 0x3a: c->rx_len = c->rx_pos = 0; break;           // SFRX
+            case 0x3b: c->tx_len = 0; break;                       // SFTX
+            }
+            c->count = 0;
+        }
+        return cc2500_status(c, read);
+    }
+    read = c->cmd & 0x80;
+    u8 addr = c->addr;
+    if (addr == 0x3f) {
+        if (read)
+            return rx_pop(c);
+        tx_push(c, mosi, SIM_FIFO);
+        return cc2500_status(c, 0);
+    }
+    if (addr == 0x3e) {
+        if (read)
+            return c->wide[addr][c->wide_pos++ & 0x07];
+        c->wide[addr][c->wide_pos++ & 0x07] = mosi;
+        return cc2500_status(c, 0);
+    }
+    if (addr >= 0x30) {
+        switch (addr) {
+        case 0x30: return 0x80;                                    // PARTNUM
+        case 0x31: return 0x03;                                    // VERSION
+        case 0x34: return 0x40;                                    // RSSI
+        case 0x35: return c->state == SIM_RX ? 0x0d : c->state == SIM_TX ? 0x13 : 0x01;  // MARCSTATE
+        case 0x3a: return c->tx_len;                               // TXBYTES
+        case 0x3b: return c->rx_len - c->rx_pos;                   // RXBYTES
+        default:   return 0;
+        }
+    }
+    if (c->cmd & 0x40)
+        c->addr = (c->addr + 1) & 0x3f;
+    if (read)
+        return c->regs[addr];
+    c->regs[addr] = mosi;
+    return cc2500_status(c, 0);
+}
+
+/* nRF24L01: every command byte returns STATUS */
+static u8 nrf_status(struct sim_chip *c)
+{
+    return (c->regs[0x07] & 0x70) | (c->rx_pos < c->rx_len ? 0x00 : 0x0e);
+}
+
+static void nrf_rx_done(struct sim_chip *c)
+{
+    c->rx_len = c->rx_pos = 0;
+    c->rx_armed = c->state == SIM_RX;
+}
+
+static int nrf_wide(u8 addr)
+{
+    return addr == 0x0a || addr == 0x0b || addr == 0x10;
+}
+
+static u8 nrf_xfer(struct sim_chip *c, u8 mosi)
+{
+    if (c->count++ == 0) {
+        c->cmd = mosi;
+        c->addr = mosi & 0x1f;
+        if (c->rx_armed && (mosi & 0xe0) != 0x20) {
+            // The packet arrives while the protocol waits for it
+            c->rx_armed = 0;
+            if (receive(NRF24L01, c->regs[0x05]))
+                c->regs[0x07] |= 0x40;  // RX_DR
+        }
+        switch (mosi) {
+        case 0xe1: c->tx_len = 0; break;        // FLUSH_TX
+        case 0xe2: nrf_rx_done(c); break;       // FLUSH_RX
+        }
+        return nrf_status(c);
+    }
+    u8 cmd = c->cmd;
+    u8 addr = c->addr;
+    if (cmd < 0x20) {   // R_REGISTER
+        if (nrf_wide(addr))
+            return c->wide[addr][c->wide_pos++ % 5];
+        switch (addr) {
+        case 0x07: return nrf_status(c);
+        case 0x17: return 0x10 | (c->rx_pos < c->rx_len ? 0x00 : 0x01);  // FIFO_STATUS
+        default:   return c->regs[addr];
+        }
+    }
+    if (cmd < 0x40) {   // W_REGISTER
+        if (nrf_wide(addr)) {
+            c->wide[addr][c->wide_pos++ % 5] = mosi;
+        } else if (addr == 0x07) {
+            c->regs[addr] &= ~(mosi & 0x70);
+        } else if (addr == 0x00) {
+            c->regs[addr] = mosi;
+            int state = ! (mosi & 0x02) ? SIM_IDLE : (mosi & 0x01) ? SIM_RX : SIM_TX;
+            if (state == SIM_RX && c->state != SIM_RX)
+                c->rx_armed = 1;
+            if (state != SIM_RX)
+                c->rx_armed = 0;
+            c->state = state;
+        } else {
+            c->regs[addr] = mosi;
+        }
+        return 0;
+    }
+    switch (cmd) {
+    case 0x60: return c->rx_len;                // R_RX_PL_WID
+    case 0x61: {                                // R_RX_PAYLOAD
+        u8 data = rx_pop(c);
+        if (c->rx_pos == c->rx_len)
+            nrf_rx_done(c);
+        return data;
+    }
+    case 0xa0: case 0xb0:                       // W_TX_PAYLOAD(_NOACK)
+        tx_push(c, mosi, 32);
+        break;
+    }
+    return 0;
+}
+
+static void nrf_deselect(struct sim_chip *c)
+{
+    if ((c->cmd == 0xa0 || c->cmd == 0xb0) && c->count > 1 && c->state == SIM_TX) {
+        transmit(NRF24L01, c->regs[0x05]);
+        c->regs[0x07] |= 0x20;  // TX_DS
+    }
+}
+
+void RADIOSIM_Reset(int chip)
+{
+    static const u8 defaults[SIM_CHIPS][12][2] = {
+        [CYRF6936] = {{0x00, 0x48}, {0x03, 0x05}, {0x06, 0x12}, {0x0f, 0x80}, {0x10, 0xa5}},
+        [A7105]    = {{0x10, 0x9e}},
+        [CC2500]   = {{0x00, 0x29}, {0x01, 0x2e}, {0x02, 0x3f}, {0x03, 0x07}, {0x04, 0xd3}, {0x05, 0x91},
+                      {0x06, 0xff}, {0x07, 0x04}, {0x08, 0x45}, {0x0d, 0x5d}, {0x0e, 0xc4}, {0x0f, 0xec}},
+        [NRF24L01] = {{0x00, 0x08}, {0x01, 0x3f}, {0x02, 0x03}, {0x03, 0x03}, {0x04, 0x03}, {0x05, 0x02},
+                      {0x06, 0x0f}, {0x07, 0x0e}},
+    };
+    if (chip < 0 || chip >= SIM_CHIPS)
+        return;
+    struct sim_chip *c = &chips[chip];
+    memset(c, 0, sizeof(*c));
+    for (int i = 0; i < 12 && (defaults[chip][i][0] || defaults[chip][i][1]); i++)
+        c->regs[defaults[chip][i][0]] = defaults[chip][i][1];
+    if (chip == NRF24L01) {
+        memset(c->wide[0x0a], 0xe7, 5);
+        memset(c->wide[0x0b], 0xc2, 5);
+        memset(c->wide[0x10], 0xe7, 5);
+    }
+}
+
+/* The chip selects are Transmitter.module_enable[], so the module is found
+ * from the pin's position in that array.  Other pins (resets) are ignored */
+void RADIOSIM_SetCS(const struct mcu_pin *pin, int level)
+{
+    if ((uintptr_t)pin < (uintptr_t)&Transmitter.module_enable[0]
+        || (uintptr_t)pin >= (uintptr_t)&Transmitter.module_enable[SIM_CHIPS])
+        return;
+    sim_init();
+    int chip = pin - Transmitter.module_enable;
+    if (! level) {
+        selected = chip;
+        chips[chip].count = 0;
+        chips[chip].wide_pos = 0;
+    } else if (selected == chip) {
+        if (chip == NRF24L01)
+            nrf_deselect(&chips[chip]);
+        selected = -1;
+    }
+}
+
+u8 RADIOSIM_Xfer(u8 mosi)
+{
+    if (selected < 0)
+        return 0xff;
+    struct sim_chip *c = &chips[selected];
+    switch (selected) {
+    case CYRF6936: return cyrf_xfer(c, mosi);
+    case A7105:    return a7105_xfer(c, mosi);
+    case CC2500:   return cc2500_xfer(c, mosi);
+    default:       return nrf_xfer(c, mosi);
+    }
+}
+
+u8 RADIOSIM_Read3Wire()
+{
+    return RADIOSIM_Xfer(0xff);
+}
+
+int RADIOSIM_QueueRx(int chip, const u8 *packet, unsigned len)
+{
+    if (chip < 0 || chip >= SIM_CHIPS || len > SIM_FIFO || queue_count[chip] == SIM_QUEUE)
+        return 0;
+    struct sim_response *resp = &queue[chip][(queue_head[chip] + queue_count[chip]) % SIM_QUEUE];
+    memcpy(resp->data, packet, len);
+    resp->len = len;
+    queue_count[chip]++;
+    return 1;
+}
+
+const struct RadioSimStats *RADIOSIM_Stats(int chip)
+{
+    return chip >= 0 && chip < SIM_CHIPS ? &stats[chip] : NULL;
+}
+
+void RADIOSIM_ClearStats()
+{
+    memset(stats, 0, sizeof(stats));
+}
+
+#define TESTNAME radiosim
+#include <tests.h>
@@ -0,0 +1,38 @@
+#ifndef _RADIO_SIM_H_
+#define _RADIO_SIM_H_
+
+/* Register level models of the CYRF6936, A7105, CC2500 and nRF24L01 used by
+ * the emulator and test targets in place of real SPI hardware.
+ *
+ * Every packet sent is counted and, if RADIOSIM_CAPTURE names a file, logged
+ * there with the (virtual) time and channel.  RADIOSIM_SCRIPT may name a file
+ * of receiver responses, one per line:
+ *     <cyrf6936|a7105|cc2500|nrf24l01> <hex bytes>
+ * Each response is handed to the chip the next time it enters receive mode.
+ */
+struct RadioSimStats {
+    u32 tx_packets;
+    u32 rx_packets;
+    u32 hops;               // channel changes between transmitted packets
+    u32 min_interval_us;    // between transmitted packets
+    u32 max_interval_us;
+    u64 first_tx_us;
+    u64 last_tx_us;
+    u8 channel;             // of the last packet
+    u8 last_len;
+    u8 last_packet[64];
+};
+
+void RADIOSIM_Reset(int chip);
+void RADIOSIM_SetCS(const struct mcu_pin *pin, int level);
+u8 RADIOSIM_Xfer(u8 mosi);
+u8 RADIOSIM_Read3Wire();
+int RADIOSIM_QueueRx(int chip, const u8 *packet, unsigned len);
+const struct RadioSimStats *RADIOSIM_Stats(int chip);
+void RADIOSIM_ClearStats();
+int RADIOSIM_DecodeXN297(const u8 *packet, unsigned len, unsigned addr_len, u8 *addr, u8 *payload);
+
+// Microseconds since start, virtual time when the emulator runs with VIRTUALTIME set
+u64 EMU_ClockUs();
+
+#endif  // _RADIO_SIM_H_
@@ -18,6 +18,5 @@ extern void PROTO_Stubs(int);
 // ADC defines
 #define NUM_ADC_CHANNELS (INP_HAS_CALIBRATION + 2) //Inputs + Temprature + Voltage
 extern volatile u16 adc_array_raw[NUM_ADC_CHANNELS];
-void ADC_Filter();
 
 #endif
@@ -112,6 +112,10 @@
     #endif
     #define PROTO_SPI_CFG SPI2_CFG
     #define PROTO_RST_PIN ((struct mcu_pin){GPIOB, GPIO11})
+    #define PROTO_SPI_TX_DMA ((struct dma_config) { \
+        .dma = DMA1,                       \
+        .stream = DMA_CHANNEL5,            \
+        })
 #endif  // PROTO_SPI
 
 #ifndef TOUCH_SPI
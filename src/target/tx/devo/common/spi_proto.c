@@ -99,6 +99,9 @@ void SPI_ProtoInit()
         usleep(10);
         GPIO_pin_clear(PROTO_RST_PIN);
     }
+#ifdef PROTO_SPI_TX_DMA
+    rcc_periph_clock_enable(get_rcc_from_port(PROTO_SPI_TX_DMA.dma));
+#endif
     if (PROTO_SPI_CFG.spi != FLASH_SPI_CFG.spi) {
         _spi_init(PROTO_SPI_CFG);
         if (HAS_4IN1_FLASH) {
@@ -27,6 +27,8 @@
 #define HAS_AUDIO_UART      0
 #define HAS_MUSIC_CONFIG    1
 
+#define FONT_CACHE_SIZE     32
+
 #define SUPPORT_CRSF_CONFIG 1
 
 #ifdef BUILDTYPE_DEV
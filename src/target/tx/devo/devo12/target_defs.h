@@ -32,6 +32,13 @@
 #define HAS_AUDIO_UART      0
 #define HAS_MUSIC_CONFIG    1
 
+#define IMAGE_CACHE_SLOTS   4
+#define FONT_CACHE_SIZE     32
+#define TELEM_HISTORY_SLOTS 4
+#define MODEL_CATALOG_SIZE  48
+#define STORAGE_CACHE_LINES 8
+#define CRC_TABLE_BITS      8
+
 #define SUPPORT_CRSF_CONFIG 1
 
 #ifdef BUILDTYPE_DEV
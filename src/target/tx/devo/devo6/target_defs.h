@@ -27,6 +27,12 @@
 #define HAS_AUDIO_UART      0
 #define HAS_MUSIC_CONFIG    1
 
+#define IMAGE_CACHE_SLOTS   2
+#define FONT_CACHE_SIZE     32
+#define TELEM_HISTORY_SLOTS 4
+#define MODEL_CATALOG_SIZE  48
+#define STORAGE_CACHE_LINES 8
+
 #ifdef BUILDTYPE_DEV
    #define DEBUG_WINDOW_SIZE 200
 #else
@@ -51,6 +51,7 @@
 #define NUM_TRIMS 6
 #define MAX_POINTS 13
 #define NUM_MIXERS ((NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS) * 4)
+#define NUM_CURVE_LUTS 0
 
 #define INP_HAS_CALIBRATION 4
 
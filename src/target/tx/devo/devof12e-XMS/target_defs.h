@@ -34,6 +34,8 @@
 #define HAS_AUDIO_UART      0
 #define HAS_MUSIC_CONFIG    1
 
+#define FONT_CACHE_SIZE     32
+
 #ifdef BUILDTYPE_DEV
    #define DEBUG_WINDOW_SIZE 200
 #else
@@ -37,6 +37,10 @@
 #define HAS_AUDIO_UART      0
 #define HAS_MUSIC_CONFIG    1
 
+#define FONT_CACHE_SIZE     32
+#define STORAGE_CACHE_LINES 4
+#define DEVOFS_INDEX_SIZE   64 //~50 files and directories
+
 #define SUPPORT_MULTI_LANGUAGE 0
 
 #ifdef BUILDTYPE_DEV
@@ -71,6 +71,8 @@
 #define NUM_TRIMS 6
 #define MAX_POINTS 13
 #define NUM_MIXERS ((NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS) * 4)
+#define NUM_CURVE_LUTS 0
+#define DATALOG_BUFSIZE 256
 
 #define INP_HAS_CALIBRATION 4
 
@@ -16,6 +16,7 @@
     #define SPIFLASH_SECTORS 16
     #define SPIFLASH_TYPE SST25VFxxxA
     #define USE_DEVOFS 1 //Must be before common_devo include
+    #define DEVOFS_INDEX_SIZE 64 //~40 files and directories
 #endif
 
 #define TXID 0xF4
@@ -72,6 +73,7 @@
 #define NUM_TRIMS 6
 #define MAX_POINTS 13
 #define NUM_MIXERS ((NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS) * 4)
+#define NUM_CURVE_LUTS 0
 
 #define INP_HAS_CALIBRATION 4
 
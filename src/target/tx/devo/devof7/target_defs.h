@@ -8,6 +8,7 @@
 #define VECTOR_TABLE_LOCATION 0x3000 //0x3000
 #define SPIFLASH_SECTOR_OFFSET 0
 #define SPIFLASH_SECTORS 16
+#define DEVOFS_INDEX_SIZE 64 //~40 files and directories
 
 #define LCD_WIDTH 24
 #define LCD_HEIGHT 12
@@ -60,6 +61,7 @@
 #define NUM_TRIMS 6
 #define MAX_POINTS 13
 #define NUM_MIXERS ((NUM_OUT_CHANNELS + NUM_VIRT_CHANNELS) * 4)
+#define NUM_CURVE_LUTS 0
 
 #define INP_HAS_CALIBRATION 5
 
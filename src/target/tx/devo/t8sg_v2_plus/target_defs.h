@@ -30,6 +30,8 @@
 #define HAS_EXTENDED_AUDIO  1
 #define HAS_AUDIO_UART      1
 #define HAS_MUSIC_CONFIG    1
+
+#define FONT_CACHE_SIZE     32
 #define HAS_BUTTON_POWER_ON 1
 #define HAS_OLED_DISPLAY    1
 #define HAS_USB_DRIVE_ERASE 1
@@ -5,6 +5,7 @@
 #include <libopencm3/stm32/spi.h>
 
 u8 PROTOSPI_read3wire();
+void PROTOSPI_xfer_burst(const u8 *tx, u8 *rx, unsigned len);
 u8 PROTOSPI_xfer(u8 byte);
 #define PROTOSPI_pin_set(io) GPIO_pin_set(io)
 #define PROTOSPI_pin_clear(io) GPIO_pin_clear(io)
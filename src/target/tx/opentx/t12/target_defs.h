@@ -55,6 +55,8 @@
   #define DEBUG_WINDOW_SIZE 0
 #endif
 
+#define FONT_CACHE_SIZE     32
+
 #define MIN_BRIGHTNESS 0
 #define DEFAULT_BATTERY_ALARM 4100
 #define DEFAULT_BATTERY_CRITICAL 3900
@@ -89,7 +91,6 @@ extern void PROTO_Stubs(int);
 // ADC defines
 #define NUM_ADC_CHANNELS (INP_HAS_CALIBRATION + 2)  // Inputs + Temprature + Voltage
 extern volatile u16 adc_array_raw[NUM_ADC_CHANNELS];
-void ADC_Filter();
 #ifndef LCD_ForceUpdate
 static inline void LCD_ForceUpdate() {}
 #endif
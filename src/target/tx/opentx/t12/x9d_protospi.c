@@ -5,6 +5,10 @@
 int SPI_ProtoGetPinConfig(int module, int state) {(void)module; (void)state; return 0;}
 u8 PROTOSPI_read3wire() { return 0x00; }
 u8 PROTOSPI_xfer(u8 byte) { return byte; }
+void PROTOSPI_xfer_burst(const u8 *tx, u8 *rx, unsigned len) {
+    if (rx)
+        tx ? memcpy(rx, tx, len) : memset(rx, 0x00, len);
+}
 void SPI_ProtoInit() {}
 int MCU_SetPin(struct mcu_pin *port, const char *name) {return 0;}
 void MCU_InitModules() {}
@@ -141,6 +141,11 @@ void _DMA_ISR()
 
 void ADC_Filter()
 {
+    //The input each of the first INP_HAS_CALIBRATION conversions belongs to
+    static const u8 adc_input[INP_HAS_CALIBRATION] = {
+        INP_THROTTLE, INP_AILERON, INP_RUDDER, INP_ELEVATOR,
+        INP_AUX2, INP_AUX3, INP_AUX4, INP_AUX5,
+    };
     for (int i = 0; i < NUM_ADC_CHANNELS; i++) {
         u32 result = 0;
         int idx = i;
@@ -149,6 +154,8 @@ void ADC_Filter()
             idx += NUM_ADC_CHANNELS;
         }
         result /= ADC_OVERSAMPLE_WINDOW_COUNT * WINDOW_SIZE;
+        if (i < INP_HAS_CALIBRATION)
+            result = CHAN_FilterInput(adc_input[i], result);
         adc_array_raw[i] = result;
     }
 }
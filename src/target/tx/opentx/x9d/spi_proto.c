@@ -101,6 +101,15 @@ u8 PROTOSPI_xfer(u8 tx)
     return rx;
 }
 
+void PROTOSPI_xfer_burst(const u8 *tx, u8 *rx, unsigned len)
+{
+    for (unsigned i = 0; i < len; i++) {
+        u8 data = PROTOSPI_xfer(tx ? tx[i] : 0x00);
+        if (rx)
+            rx[i] = data;
+    }
+}
+
 #if HAS_MULTIMOD_SUPPORT
 int SPI_ConfigSwitch(unsigned csn_high, unsigned csn_low)
 {
@@ -41,6 +41,8 @@
 
 #define INP_HAS_CALIBRATION 8
 
+#define FONT_CACHE_SIZE 32
+
 /* Compute voltage from y = 0.003246x + 0.4208 */
 #define VOLTAGE_NUMERATOR 324
 #define VOLTAGE_OFFSET    421
@@ -0,0 +1 @@
+#include "../../../drivers/mcu/emu/radio_sim.c"
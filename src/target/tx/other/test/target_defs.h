@@ -2,4 +2,7 @@
 #include "target/drivers/mcu/emu/common_emu.h"
 #include "target/tx/devo/devo8/target_defs.h"
 
+//RAM backed flash, reaching past SPIFLASH_SECTOR_OFFSET for the 16 devofs sectors
+#define TEST_FLASH_SIZE ((SPIFLASH_SECTOR_OFFSET + 16) * 0x1000)
+
 #define BUTTON_MAP { 'A', 'Q', 'D', 'E', 'S', 'W', 'F', 'R', 'G', 'T', 'H', 'Y', FL_Left, FL_Right, FL_Down, FL_Up, 13/*FL_Enter*/, FL_Escape, 0 }
@@ -12,6 +12,7 @@
     You should have received a copy of the GNU General Public License
     along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
 */
+#include <unistd.h>
 #include "common.h"
 #include "mixer.h"
 #include "config/tx.h"
@@ -89,10 +90,16 @@ u32 CLOCK_getms()
     return 100000;
 }
 
+u64 EMU_ClockUs()
+{
+    return (u64)CLOCK_getms() * 1000;
+}
+
 void PWR_Sleep()
 {
 }
 
+#undef usleep
 void _usleep(u32 usec) {
     usleep(usec);
 }
@@ -129,6 +136,37 @@ volatile mixsync_t mixer_sync;
 
 u32  SPIFlash_ReadID() { return 0x12345678; }
 void SPIFlash_BlockWriteEnable(unsigned enable) {(void)enable;}
+
+/* RAM backed flash for the storage cache and devofs tests */
+u8 test_flash[TEST_FLASH_SIZE];
+unsigned test_flash_reads;
+unsigned test_flash_writes;
+int test_flash_cut = -1;    // writes and erases left before the power is cut, -1 for no cut
+static int flash_powered()
+{
+    if (test_flash_cut < 0)
+        return 1;
+    if (! test_flash_cut)
+        return 0;
+    test_flash_cut--;
+    return 1;
+}
+void SPIFlash_ReadBytes(u32 readAddress, u32 length, u8 * buffer)
+{
+    test_flash_reads++;
+    memcpy(buffer, test_flash + readAddress, length);
+}
+void SPIFlash_WriteBytes(u32 writeAddress, u32 length, const u8 * buffer)
+{
+    test_flash_writes++;
+    if (flash_powered())
+        memcpy(test_flash + writeAddress, buffer, length);
+}
+void SPIFlash_EraseSector(u32 sectorAddress)
+{
+    if (flash_powered())
+        memset(test_flash + sectorAddress, 0, 0x1000);
+}
 void SPITouch_Init() {}
 
 u8 *BOOTLOADER_Read(int idx) {
@@ -50,6 +50,10 @@ static inline void LCD_ForceUpdate() {}
     #define DEBUG_WINDOW_SIZE 0
 #endif
 
+#define FONT_CACHE_SIZE     32
+#define STORAGE_CACHE_LINES 4
+#define DEVOFS_INDEX_SIZE   128 //~70 files and directories
+
 #define LCD_WIDTH 480
 #define LCD_HEIGHT 320
 
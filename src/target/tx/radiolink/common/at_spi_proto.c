@@ -33,6 +33,15 @@ void SPI_ProtoInit()
     GPIO_pin_set(PROTO_SPI.csn);
 }
 
+void PROTOSPI_xfer_burst(const u8 *tx, u8 *rx, unsigned len)
+{
+    for (unsigned i = 0; i < len; i++) {
+        u8 data = PROTOSPI_xfer(tx ? tx[i] : 0x00);
+        if (rx)
+            rx[i] = data;
+    }
+}
+
 void MCU_InitModules()
 {
 }
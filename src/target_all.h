@@ -9,3 +9,45 @@
 #ifndef SUPPORT_CRSF_CONFIG
 #define SUPPORT_CRSF_CONFIG 0
 #endif
+
+#ifndef NUM_CURVE_LUTS
+#define NUM_CURVE_LUTS 8
+#endif
+
+#ifndef DATALOG_BUFSIZE
+#define DATALOG_BUFSIZE 1024
+#endif
+
+#ifndef FONT_CACHE_SIZE
+#define FONT_CACHE_SIZE 0
+#endif
+
+#ifndef SOUND_TABLE_NOTES
+#define SOUND_TABLE_NOTES 200
+#endif
+
+#ifndef CRC_TABLE_BITS
+#define CRC_TABLE_BITS 4
+#endif
+
+#ifndef TELEM_HISTORY_SLOTS
+#define TELEM_HISTORY_SLOTS 0
+#endif
+
+#ifndef TELEM_HISTORY_SAMPLES
+#define TELEM_HISTORY_SAMPLES 60
+#endif
+
+#ifndef IMAGE_CACHE_SLOTS
+#define IMAGE_CACHE_SLOTS 0
+#endif
+
+#ifndef MODEL_CATALOG_SIZE
+#define MODEL_CATALOG_SIZE 0
+#endif
+
+#ifndef STORAGE_CACHE_LINES
+// Each line costs 264 bytes of RAM, which the 16kB targets (devo7e, devof7,
+// devof4) can't spare
+#define STORAGE_CACHE_LINES 0
+#endif
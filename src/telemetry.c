@@ -38,7 +38,25 @@ static u8 telem_idx = 0;
 static u32 last_updated[TELEM_UPDATE_SIZE] = {0};
 static u32 music_time = 0;
 static u32 error_time = 0;
-#define CHECK_DURATION 500
+
+/* Alarms are evaluated when their source is updated rather than polled:
+ * alarm_trigger[] maps each telemetry value to the alarms watching it, and
+ * TELEMETRY_SetUpdated() marks those alarms pending for TELEMETRY_Alarm().
+ * The map is rebuilt whenever the configuration may have changed.
+ * Protocol interrupts set the pending flags and the main loop clears them, so
+ * each alarm has its own byte: a read-modify-write of a shared mask could lose
+ * an update that arrives in between. */
+#define ALARM_DEBOUNCE   2   // consecutive out-of-limit updates before an alarm is set
+#define ALARM_HYSTERESIS 32  // clear only once the value is back by 1/32 of the limit
+typedef u16 alarm_mask_t;
+ctassert(TELEM_NUM_ALARMS <= 16, alarm_mask_too_small);
+static alarm_mask_t alarm_trigger[TELEM_VALS];
+static volatile u8 alarm_pending[TELEM_NUM_ALARMS];
+static alarm_mask_t alarm_active;    // alarms in state 1
+static u16 alarm_generation;
+#if TELEM_HISTORY_SLOTS
+static void history_mark(int src);
+#endif
 
 void _get_value_str(char *str, s32 value, u8 decimals, char units)
 {
@@ -284,9 +302,72 @@ s32 TELEMETRY_GetMinValue(int idx)
     return 0;
 }
 
+#if HAS_EXTENDED_TELEMETRY
+/* Received telemetry frames are queued by the uart/radio interrupt and
+ * decoded by the protocol from the main loop, so the interrupt only has to
+ * frame and check the data.  There is a single producer and a single
+ * consumer: only the interrupt moves frame_head and only the main loop moves
+ * frame_tail.  Frames are stored as a length byte followed by the data, and
+ * the u8 indices wrap with the 256 byte buffer. */
+static u8 frame_queue[256];
+static volatile u8 frame_head;
+static volatile u8 frame_tail;
+
+void TELEMETRY_QueueFrame(const u8 *frame, u8 len)
+{
+    u8 head = frame_head;
+    u8 space = frame_tail - head - 1;
+    if (len == 0 || len >= space)
+        return;  // Queue is full, drop the frame
+    frame_queue[head++] = len;
+    while (len--)
+        frame_queue[head++] = *frame++;
+    // The frame must be complete before the consumer can see it
+    asm volatile ("" ::: "memory");
+    frame_head = head;
+}
+
+u8 TELEMETRY_NextFrame(u8 *frame, u8 size)
+{
+    u8 tail = frame_tail;
+    while (tail != frame_head) {
+        asm volatile ("" ::: "memory");
+        u8 len = frame_queue[tail++];
+        if (len <= size) {
+            for (u8 i = 0; i < len; i++)
+                frame[i] = frame_queue[tail++];
+            frame_tail = tail;
+            return len;
+        }
+        // Too big for the caller, skip it
+        tail += len;
+        frame_tail = tail;
+    }
+    return 0;
+}
+
+int TELEMETRY_FramesQueued()
+{
+    return frame_head != frame_tail;
+}
+
+void TELEMETRY_ResetFrames()
+{
+    frame_tail = frame_head;
+}
+#endif  // HAS_EXTENDED_TELEMETRY
+
 void TELEMETRY_SetUpdated(int idx)
 {
     Telemetry.updated[idx/32] |= (1 << idx % 32);
+    alarm_mask_t trigger = alarm_trigger[idx];
+    for (int i = 0; trigger; i++, trigger >>= 1) {
+        if (trigger & 1)
+            alarm_pending[i] = 1;
+    }
+#if TELEM_HISTORY_SLOTS
+    history_mark(idx);
+#endif
 }
 
 int TELEMETRY_Type()
@@ -324,6 +405,50 @@ void TELEMETRY_SetType(int type)
 }
 
 //#define DEBUG_TELEMALARM
+static void compile_alarms()
+{
+    memset(alarm_trigger, 0, sizeof(alarm_trigger));
+    alarm_active = 0;
+    for (int i = 0; i < TELEM_NUM_ALARMS; i++) {
+        u8 src = Model.alarms[i].src;
+        if (src && src < TELEM_VALS)
+            alarm_trigger[src] |= 1 << i;
+        if (Model.alarms[i].state == 1)
+            alarm_active |= 1 << i;
+    }
+}
+
+static void check_alarm(int idx, u32 current_time)
+{
+    struct TelemetryAlarm *alarm = &Model.alarms[idx];
+    s32 value = TELEMETRY_GetValue(alarm->src) - alarm->mute_value;
+
+    if ((value <= alarm->value) == alarm->above) {
+        if (!alarm->state && ++alarm->debounce >= ALARM_DEBOUNCE) {
+            alarm->state++;
+            alarm_active |= 1 << idx;
+            alarm->limit_threshold_time = current_time + (alarm->threshold * 1000);
+#ifdef DEBUG_TELEMALARM
+            printf("set: 0x%x\n\n", idx);
+#endif
+        }
+        return;
+    }
+    alarm->debounce = 0;
+    if (alarm->state) {
+        s32 hysteresis = (alarm->value < 0 ? -alarm->value : alarm->value) / ALARM_HYSTERESIS;
+        if (alarm->above ? value > alarm->value + hysteresis
+                         : value <= alarm->value - hysteresis) {
+            alarm->state = 0;
+            alarm->limit_threshold_time = 0;
+            alarm_active &= ~(1 << idx);
+#ifdef DEBUG_TELEMALARM
+            printf("clear: 0x%x\n\n", idx);
+#endif
+        }
+    }
+}
+
 void TELEMETRY_Alarm()
 {
     if (PROTOCOL_GetTelemetryState() != PROTO_TELEM_ON)
@@ -337,37 +462,38 @@ void TELEMETRY_Alarm()
             last_updated[i] = Telemetry.updated[i];
             Telemetry.updated[i] = 0;
         }
+        // Alarms on values that stopped updating never see an event
+        for (int i = 0; i < TELEM_NUM_ALARMS; i++) {
+            if (!TELEMETRY_IsUpdated(Model.alarms[i].src))
+                TELEMETRY_ResetAlarm(i);
+        }
+        compile_alarms();
     }
-    // don't need to check all the 6 telem-configs at one time, this is not a critical and urgent task
-    // instead, check 1 of them at a time
-    telem_idx = (telem_idx + 1) % TELEM_NUM_ALARMS;
-    struct TelemetryAlarm *alarm = &Model.alarms[telem_idx];
-
-    if (current_time >= alarm->alarm_time) {
-        alarm->alarm_time = current_time + CHECK_DURATION;
-        if (!TELEMETRY_IsUpdated(alarm->src)) {
-            TELEMETRY_ResetAlarm(telem_idx);
-        } else if ((TELEMETRY_GetValue( alarm->src ) - alarm->mute_value <=
-                                        alarm->value) == alarm->above) {
-            if (!alarm->state) {
-                alarm->state++;
-                alarm->limit_threshold_time = current_time + (alarm->threshold * 1000);
-#ifdef DEBUG_TELEMALARM
-                printf("set: 0x%x\n\n", telem_idx);
-#endif
-            }
-        } else if (alarm->state) {
-            alarm->state = 0;
-            alarm->limit_threshold_time = 0;
-#ifdef DEBUG_TELEMALARM
-            printf("clear: 0x%x\n\n", telem_idx);
-#endif
+    if (alarm_generation != config_generation) {
+        alarm_generation = config_generation;
+        compile_alarms();
+    }
+    for (int i = 0; i < TELEM_NUM_ALARMS; i++) {
+        if (alarm_pending[i]) {
+            // Cleared first: an update arriving during the check sets it again
+            alarm_pending[i] = 0;
+            check_alarm(i, current_time);
         }
     }
 
-    if (alarm->state == 1 &&
-        current_time >= music_time &&
-        current_time >= alarm->limit_threshold_time) {
+    if (!alarm_active || current_time < music_time)
+        return;
+    // Announce the active alarms in turn
+    struct TelemetryAlarm *alarm = NULL;
+    for (int i = 0; i < TELEM_NUM_ALARMS; i++) {
+        telem_idx = (telem_idx + 1) % TELEM_NUM_ALARMS;
+        if (Model.alarms[telem_idx].state == 1 &&
+            current_time >= Model.alarms[telem_idx].limit_threshold_time) {
+            alarm = &Model.alarms[telem_idx];
+            break;
+        }
+    }
+    if (alarm) {
         music_time = current_time + Transmitter.telem_alert_interval*1000;
         // telem_idx > 2 is exclude first 3 alarms from jump action (interim solution)
         // <= (9 + type) is limit jump action to only visible telemetry monitor values
@@ -502,7 +628,9 @@ void TELEMETRY_ResetAlarm(int i)
 {
     struct TelemetryAlarm *alarm = &Model.alarms[i];
     alarm->state = 0;
+    alarm->debounce = 0;
     alarm->mute_value = 0;
+    alarm_active &= ~(1 << i);
 }
 
 void TELEMETRY_ResetValues(void)
@@ -510,6 +638,9 @@ void TELEMETRY_ResetValues(void)
     // Reset cumulative values, altitude ground level, etc.
     // Exact values are protocol depenedent
     PROTOCOL_ResetTelemetry();
+#if TELEM_HISTORY_SLOTS
+    TELEMETRY_HistoryReset();
+#endif
     SOUND_SetFrequency(3951, Transmitter.volume * 10);
     SOUND_StartWithoutVibrating(100, NULL);
 }
@@ -521,6 +652,7 @@ void TELEMETRY_MuteAlarm()
         if (alarm->state == 1) {
             alarm->mute_value = TELEMETRY_GetValue(alarm->src) - (alarm->above << 8);
             alarm->state++;
+            alarm_active &= ~(1 << i);
         }
     }
 }
@@ -535,3 +667,7 @@ int TELEMETRY_HasAlarm(int src)
 
     return 0;
 }
+#include "telemetry/telem_history.c"
+
+#define TESTNAME telemetry
+#include <tests.h>
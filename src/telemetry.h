@@ -222,6 +222,20 @@ struct Telemetry {
     volatile u32 updated[TELEM_UPDATE_SIZE];
 };
 
+enum {
+    TELEM_HISTORY_1SEC,
+    TELEM_HISTORY_10SEC,
+    TELEM_HISTORY_LEVELS,
+};
+
+// Running statistics since the history was last reset
+struct TelemetryStats {
+    s32 min;
+    s32 max;
+    s32 mean;
+    u32 count;
+};
+
 enum {
     PROTO_TELEM_UNSUPPORTED = 0,
     PROTO_TELEM_OFF = 1,
@@ -348,9 +362,9 @@ struct TelemetryAlarm {
     u8 above;
 
     u8 state;  // 3 states: 0 = off, 1 = on, 2 = mute
+    u8 debounce;
     s32 value;
     s32 mute_value;
-    u32 alarm_time;
     u32 limit_threshold_time;
 };
 
@@ -373,4 +387,14 @@ int TELEMETRY_Type();
 void TELEMETRY_SetType(int type);
 int TELEMETRY_GetNumTelemSrc();
 void TELEMETRY_ResetValues();
+void TELEMETRY_QueueFrame(const u8 *frame, u8 len);
+u8 TELEMETRY_NextFrame(u8 *frame, u8 size);
+int TELEMETRY_FramesQueued();
+void TELEMETRY_ResetFrames();
+int TELEMETRY_HistoryTrack(int src);
+void TELEMETRY_HistoryUntrack(int src);
+void TELEMETRY_HistoryUpdate();
+void TELEMETRY_HistoryReset();
+int TELEMETRY_HistoryGet(int src, int level, s32 *values, int max);
+const struct TelemetryStats *TELEMETRY_HistoryStats(int src);
 #endif
@@ -0,0 +1,236 @@
+/*
+ This project is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ Deviation is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with Deviation.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if TELEM_HISTORY_SLOTS
+/* Per sensor history for trend displays.
+ * Each tracked source is sampled from the main loop.  The raw samples feed
+ * running min/max/mean statistics and are averaged into one value per second
+ * (TELEM_HISTORY_1SEC), and ten of those into one value per 10 seconds
+ * (TELEM_HISTORY_10SEC).  Each resolution keeps the last TELEM_HISTORY_SAMPLES
+ * values.  Only values received since the previous sample are counted:
+ * TELEMETRY_SetUpdated() marks the slot, so a sensor that stopped reporting
+ * adds nothing instead of repeating its last value.
+ *
+ * A ring stores each value as an s16 offset from the base of its block.  A
+ * block is a run of consecutive values that all fit within the s16 range of
+ * the first one, so values are stored exactly.  A value that doesn't fit
+ * starts a new block; once all HISTORY_BLOCKS blocks are in use, the oldest
+ * one is dropped with its values.  A steady sensor fills the whole ring from
+ * one or two blocks */
+#define HISTORY_DECIMATION 10
+#define HISTORY_BLOCKS     4
+
+struct history_ring {
+    s16 delta[TELEM_HISTORY_SAMPLES];
+    s32 base[HISTORY_BLOCKS];
+    u8 len[HISTORY_BLOCKS];     // values in each block
+    u8 head;                    // next value
+    u8 count;                   // values in all blocks
+    u8 block_head;              // next block
+    u8 block_count;
+};
+
+struct history_slot {
+    u8 src;                 // 0 if the slot is unused
+    volatile u8 updated;    // set by TELEMETRY_SetUpdated(), cleared once sampled
+    u8 pending;             // 1 sec samples summed into sum_1sec
+    u16 raw_count;          // raw samples summed into raw_sum this second
+    s32 raw_sum;
+    s32 sum_1sec;
+    struct TelemetryStats stats;   // mean is only computed when it is read
+    int64_t stats_sum;
+    struct history_ring ring[TELEM_HISTORY_LEVELS];
+};
+
+static struct history_slot history[TELEM_HISTORY_SLOTS];
+static u32 history_next_ms;
+static u8 history_victim;
+
+static struct history_slot *history_find(int src)
+{
+    for (int i = 0; i < TELEM_HISTORY_SLOTS; i++) {
+        if (history[i].src == src)
+            return &history[i];
+    }
+    return NULL;
+}
+
+static void history_clear(struct history_slot *slot)
+{
+    u8 src = slot->src;
+    memset(slot, 0, sizeof(*slot));
+    slot->src = src;
+}
+
+static u8 history_oldest_block(struct history_ring *ring)
+{
+    return (ring->block_head + HISTORY_BLOCKS - ring->block_count) % HISTORY_BLOCKS;
+}
+
+static void history_push(struct history_slot *slot, int level, s32 value)
+{
+    struct history_ring *ring = &slot->ring[level];
+    if (ring->count == TELEM_HISTORY_SAMPLES) {
+        //Overwrite the oldest value
+        u8 oldest = history_oldest_block(ring);
+        ring->count--;
+        if (--ring->len[oldest] == 0)
+            ring->block_count--;
+    }
+    u8 block = (ring->block_head + HISTORY_BLOCKS - 1) % HISTORY_BLOCKS;
+    s32 delta = value - ring->base[block];
+    if (! ring->block_count || delta > INT16_MAX || delta < INT16_MIN) {
+        if (ring->block_count == HISTORY_BLOCKS) {
+            u8 oldest = history_oldest_block(ring);
+            ring->count -= ring->len[oldest];
+            ring->block_count--;
+        }
+        block = ring->block_head;
+        ring->block_head = (block + 1) % HISTORY_BLOCKS;
+        ring->block_count++;
+        ring->base[block] = value;
+        ring->len[block] = 0;
+        delta = 0;
+    }
+    ring->delta[ring->head] = delta;
+    if (++ring->head == TELEM_HISTORY_SAMPLES)
+        ring->head = 0;
+    ring->len[block]++;
+    ring->count++;
+}
+
+static void history_sample(u32 now)
+{
+    int tick = (s32)(now - history_next_ms) >= 0;
+    if (tick)
+        history_next_ms = now + 1000;
+    for (int i = 0; i < TELEM_HISTORY_SLOTS; i++) {
+        struct history_slot *slot = &history[i];
+        if (! slot->src)
+            continue;
+        if (slot->updated) {
+            slot->updated = 0;
+            s32 value = TELEMETRY_GetValue(slot->src);
+            struct TelemetryStats *stats = &slot->stats;
+            if (! stats->count) {
+                stats->min = stats->max = value;
+            } else if (value < stats->min) {
+                stats->min = value;
+            } else if (value > stats->max) {
+                stats->max = value;
+            }
+            stats->count++;
+            slot->stats_sum += value;
+            slot->raw_sum += value;
+            slot->raw_count++;
+        }
+        if (! tick || ! slot->raw_count)
+            continue;
+        s32 value = slot->raw_sum / slot->raw_count;
+        slot->raw_sum = 0;
+        slot->raw_count = 0;
+        history_push(slot, TELEM_HISTORY_1SEC, value);
+        slot->sum_1sec += value;
+        if (++slot->pending == HISTORY_DECIMATION) {
+            history_push(slot, TELEM_HISTORY_10SEC, slot->sum_1sec / HISTORY_DECIMATION);
+            slot->sum_1sec = 0;
+            slot->pending = 0;
+        }
+    }
+}
+
+static void history_mark(int src)
+{
+    for (int i = 0; i < TELEM_HISTORY_SLOTS; i++) {
+        if (history[i].src == src)
+            history[i].updated = 1;
+    }
+}
+
+/* If all slots are in use, the slots are reused in the order they were taken */
+int TELEMETRY_HistoryTrack(int src)
+{
+    if (src <= 0 || src >= TELEM_VALS)
+        return 0;
+    if (history_find(src))
+        return 1;
+    struct history_slot *slot = history_find(0);
+    if (! slot) {
+        slot = &history[history_victim];
+        history_victim = (history_victim + 1) % TELEM_HISTORY_SLOTS;
+    }
+    slot->src = 0;
+    history_clear(slot);
+    slot->src = src;
+    return 1;
+}
+
+void TELEMETRY_HistoryUntrack(int src)
+{
+    struct history_slot *slot = history_find(src);
+    if (slot) {
+        slot->src = 0;
+        history_clear(slot);
+    }
+}
+
+void TELEMETRY_HistoryUpdate()
+{
+    history_sample(CLOCK_getms());
+}
+
+void TELEMETRY_HistoryReset()
+{
+    for (int i = 0; i < TELEM_HISTORY_SLOTS; i++)
+        history_clear(&history[i]);
+}
+
+int TELEMETRY_HistoryGet(int src, int level, s32 *values, int max)
+{
+    struct history_slot *slot = history_find(src);
+    if (! slot || src <= 0)
+        return 0;
+    struct history_ring *ring = &slot->ring[level];
+    int count = ring->count < max ? ring->count : max;
+    int skip = ring->count - count;
+    int idx = ring->head - ring->count;
+    if (idx < 0)
+        idx += TELEM_HISTORY_SAMPLES;
+    //Walk the blocks from the oldest, skipping the values that don't fit
+    u8 block = history_oldest_block(ring);
+    int i = 0;
+    for (int b = 0; b < ring->block_count; b++) {
+        for (int j = 0; j < ring->len[block]; j++) {
+            if (skip)
+                skip--;
+            else
+                values[i++] = ring->base[block] + ring->delta[idx];
+            if (++idx == TELEM_HISTORY_SAMPLES)
+                idx = 0;
+        }
+        block = (block + 1) % HISTORY_BLOCKS;
+    }
+    return count;
+}
+
+const struct TelemetryStats *TELEMETRY_HistoryStats(int src)
+{
+    struct history_slot *slot = history_find(src);
+    if (! slot || src <= 0 || ! slot->stats.count)
+        return NULL;
+    slot->stats.mean = slot->stats_sum / (s32)slot->stats.count;
+    return &slot->stats;
+}
+#endif  // TELEM_HISTORY_SLOTS
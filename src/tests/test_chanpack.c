@@ -0,0 +1,70 @@
+#include "CuTest.h"
+
+/* The scale_channel() the protocols used before */
+static s32 ref_scale_range(s32 chanval, s32 destMin, s32 destMax)
+{
+    s32 range = destMax - destMin;
+    if (chanval < CHAN_MIN_VALUE)
+        chanval = CHAN_MIN_VALUE;
+    else if (chanval > CHAN_MAX_VALUE)
+        chanval = CHAN_MAX_VALUE;
+    return (range * (chanval - CHAN_MIN_VALUE)) / (CHAN_MAX_VALUE - CHAN_MIN_VALUE) + destMin;
+}
+
+void TestChanPackScale(CuTest *t)
+{
+    static const s32 ranges[][2] = {
+        {0, 0xff}, {0, 0x3ff}, {0x3ff, 0}, {0xe1, 0x00}, {0x3C, -0x3C}, {0x44, 0xBC},
+        {1000, 2000}, {0, 65535}, {-30000, 30000}, {0, 0},
+    };
+    struct ChanScale scale;
+    for (unsigned r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        CHANPACK_InitRange(&scale, ranges[r][0], ranges[r][1]);
+        for (s32 v = CHAN_MIN_VALUE * 3 / 2; v <= CHAN_MAX_VALUE * 3 / 2; v++) {
+            if (CHANPACK_Scale(&scale, v) != ref_scale_range(v, ranges[r][0], ranges[r][1]))
+                CuAssertIntEquals(t, ref_scale_range(v, ranges[r][0], ranges[r][1]), CHANPACK_Scale(&scale, v));
+        }
+    }
+    // SBUS/CRSF and SUMD scaling (not clamped, truncated towards the center)
+    CHANPACK_InitScale(&scale, 0, 992, 800, CHAN_MAX_VALUE);
+    for (s32 v = CHAN_MIN_VALUE * 3 / 2; v <= CHAN_MAX_VALUE * 3 / 2; v++) {
+        if (CHANPACK_Scale(&scale, v) != v * 800 / CHAN_MAX_VALUE + 992)
+            CuAssertIntEquals(t, v * 800 / CHAN_MAX_VALUE + 992, CHANPACK_Scale(&scale, v));
+    }
+    CHANPACK_InitScale(&scale, 0, 12000, 3200, CHAN_MAX_VALUE);
+    CuAssertIntEquals(t, 8800, CHANPACK_Scale(&scale, CHAN_MIN_VALUE));
+    CuAssertIntEquals(t, 15200, CHANPACK_Scale(&scale, CHAN_MAX_VALUE));
+}
+
+void TestChanPackPack(CuTest *t)
+{
+    u16 channels[16];
+    u8 packet[24];
+    u8 ref[22];
+    for (int i = 0; i < 16; i++)
+        channels[i] = 172 + i * 113 + (i & 1) * 0x400;
+
+    // Hand unrolled SBUS packing
+    memset(ref, 0, sizeof(ref));
+    for (int bit = 0; bit < 16 * 11; bit++) {
+        if (channels[bit / 11] & (1 << (bit % 11)))
+            ref[bit / 8] |= 1 << (bit % 8);
+    }
+    memset(packet, 0xaa, sizeof(packet));
+    CuAssertIntEquals(t, 22, CHANPACK_Pack(packet, channels, 16, 11, CHANPACK_LSB_FIRST));
+    CuAssertTrue(t, memcmp(packet, ref, 22) == 0);
+    CuAssertIntEquals(t, 0xaa, packet[22]);
+
+    // MSB first, with a partial last byte
+    memset(ref, 0, sizeof(ref));
+    for (int bit = 0; bit < 5 * 10; bit++) {
+        if (channels[bit / 10] & (0x200 >> (bit % 10)))
+            ref[bit / 8] |= 0x80 >> (bit % 8);
+    }
+    CuAssertIntEquals(t, 7, CHANPACK_Pack(packet, channels, 5, 10, CHANPACK_MSB_FIRST));
+    CuAssertTrue(t, memcmp(packet, ref, 7) == 0);
+
+    CuAssertIntEquals(t, 4, CHANPACK_Pack(packet, channels, 2, 16, CHANPACK_MSB_FIRST));
+    CuAssertIntEquals(t, channels[0] >> 8, packet[0]);
+    CuAssertIntEquals(t, channels[1] & 0xff, packet[3]);
+}
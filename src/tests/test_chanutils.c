@@ -0,0 +1,98 @@
+#include "CuTest.h"
+
+static s32 ref_normalize(const struct StickCalibration *cal, s32 value)
+{
+    s32 max = cal->max;
+    s32 min = cal->min;
+    s32 zero = cal->zero;
+    if (!zero)
+        zero = ((u32)max + min) / 2;
+    max = (max - zero) * 99 / 100;
+    min = (min - zero) * 99 / 100;
+    if (value >= zero)
+        value = (value - zero) * CHAN_MAX_VALUE / max;
+    else
+        value = (value - zero) * CHAN_MIN_VALUE / min;
+    if (value > CHAN_MAX_VALUE)
+        value = CHAN_MAX_VALUE;
+    if (value < CHAN_MIN_VALUE)
+        value = CHAN_MIN_VALUE;
+    return value;
+}
+
+void TestChanScaleInput(CuTest *t)
+{
+    const struct StickCalibration cal[] = {
+        {3900, 150, 2000, 0},
+        {4095, 0, 0, 0},        // no zero: centered between min and max
+        {2100, 1900, 2010, 0},  // narrow range
+    };
+    struct StickCalibration saved = Transmitter.calibration[0];
+    for (unsigned c = 0; c < sizeof(cal) / sizeof(cal[0]); c++) {
+        Transmitter.calibration[0] = cal[c];
+        CHAN_UpdateCalibration();
+        for (s32 value = 0; value < 4096; value += 7) {
+            s32 diff = CHAN_ScaleInput(1, value) - ref_normalize(&cal[c], value);
+            CuAssertTrue(t, diff >= -1 && diff <= 1);
+        }
+    }
+    // A missing calibration must not divide by zero
+    memset(&Transmitter.calibration[0], 0, sizeof(Transmitter.calibration[0]));
+    CHAN_UpdateCalibration();
+    CuAssertIntEquals(t, 0, CHAN_ScaleInput(1, 1234));
+    Transmitter.calibration[0] = saved;
+    CHAN_UpdateCalibration();
+}
+
+void TestChanFilterInput(CuTest *t)
+{
+    u8 saved = Transmitter.calibration[0].filter;
+
+    Transmitter.calibration[0].filter = ADC_FILTER_NONE;
+    CHAN_UpdateCalibration();
+    CuAssertIntEquals(t, 1000, CHAN_FilterInput(1, 1000));
+    CuAssertIntEquals(t, -500, CHAN_FilterInput(1, -500));
+
+    // A single sample spike is removed by the 3 tap median, two by the 5 tap one
+    Transmitter.calibration[0].filter = ADC_FILTER_MEDIAN3;
+    CHAN_UpdateCalibration();
+    CuAssertIntEquals(t, 100, CHAN_FilterInput(1, 100));
+    CuAssertIntEquals(t, 100, CHAN_FilterInput(1, 4000));
+    CuAssertIntEquals(t, 100, CHAN_FilterInput(1, 100));
+    CuAssertIntEquals(t, 100, CHAN_FilterInput(1, 100));
+    CuAssertIntEquals(t, 100, CHAN_FilterInput(1, 900));
+    CuAssertIntEquals(t, 900, CHAN_FilterInput(1, 900));
+
+    Transmitter.calibration[0].filter = ADC_FILTER_MEDIAN5;
+    CHAN_UpdateCalibration();
+    CuAssertIntEquals(t, -200, CHAN_FilterInput(1, -200));
+    CuAssertIntEquals(t, -200, CHAN_FilterInput(1, 3000));
+    CuAssertIntEquals(t, -200, CHAN_FilterInput(1, 3000));
+    for (int i = 0; i < 3; i++)
+        CuAssertIntEquals(t, -200, CHAN_FilterInput(1, -200));
+    CuAssertIntEquals(t, -200, CHAN_FilterInput(1, 700));
+    CuAssertIntEquals(t, -200, CHAN_FilterInput(1, 700));
+    CuAssertIntEquals(t, 700, CHAN_FilterInput(1, 700));
+
+    // The IIR modes approach a step monotonically, the heavier ones more slowly
+    s32 last[3];
+    for (int mode = ADC_FILTER_IIR2; mode <= ADC_FILTER_IIR8; mode++) {
+        Transmitter.calibration[0].filter = mode;
+        CHAN_UpdateCalibration();
+        CuAssertIntEquals(t, 0, CHAN_FilterInput(1, 0));
+        s32 prev = 0;
+        for (int i = 0; i < 4; i++) {
+            s32 value = CHAN_FilterInput(1, 1000);
+            CuAssertTrue(t, value > prev && value <= 1000);
+            prev = value;
+        }
+        last[mode - ADC_FILTER_IIR2] = prev;
+        for (int i = 0; i < 200; i++)
+            prev = CHAN_FilterInput(1, 1000);
+        CuAssertIntEquals(t, 1000, prev);
+    }
+    CuAssertTrue(t, last[0] > last[1] && last[1] > last[2]);
+
+    Transmitter.calibration[0].filter = saved;
+    CHAN_UpdateCalibration();
+}
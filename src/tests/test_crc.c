@@ -0,0 +1,96 @@
+#include "CuTest.h"
+
+/* Bit-at-a-time implementations the table driven versions replaced */
+static u16 ref_crc16_msb(u16 crc, u16 poly, const u8 *data, int len)
+{
+    for (int i = 0; i < len; i++) {
+        crc ^= data[i] << 8;
+        for (int j = 0; j < 8; j++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ poly : crc << 1;
+    }
+    return crc;
+}
+
+static u8 ref_crc8_msb(u8 crc, u8 poly, const u8 *data, int len)
+{
+    for (int i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; j++)
+            crc = (crc & 0x80) ? (crc << 1) ^ poly : crc << 1;
+    }
+    return crc;
+}
+
+static u16 ref_crc16_frsky(const u8 *data, int len)
+{
+    static const u16 CRC_Short[] = {
+      0x0000,0x1189,0x2312,0x329b,0x4624,0x57ad,0x6536,0x74bf,
+      0x8c48,0x9dc1,0xaf5a,0xbed3,0xca6c,0xdbe5,0xe97e,0xf8f7,
+    };
+    u16 crc = 0;
+    for (int i = 0; i < len; i++) {
+        u8 val = (u8)(crc >> 8) ^ data[i];
+        crc = (crc << 8) ^ CRC_Short[val & 0x0f] ^ (0x1081 * (val >> 4));
+    }
+    return crc;
+}
+
+static u32 ref_crc32(const u8 *data, int len)
+{
+    u32 crc = ~0;
+    for (int i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; j++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+    return ~crc;
+}
+
+void TestCrcCheckValues(CuTest *t)
+{
+    const char *check = "123456789";
+    CuAssertIntEquals(t, 0xF4, Crc8Update(0, check, 9));
+    CuAssertIntEquals(t, 0xBC, Crc8DvbS2Update(0, check, 9));
+    CuAssertIntEquals(t, 0x31C3, Crc16CcittUpdate(0, check, 9));
+    CuAssertIntEquals(t, 0x29B1, Crc16CcittUpdate(0xffff, check, 9));
+    CuAssertIntEquals(t, 0xCBF43926, Crc(check, 9));
+}
+
+void TestCrcReference(CuTest *t)
+{
+    u8 data[67];
+    u32 seed = 0x1234;
+    for (unsigned i = 0; i < sizeof(data); i++)
+        data[i] = rand32_r(&seed, 0);
+
+    // Cover every length so the slice-by-4 tail and misaligned starts are exercised
+    for (unsigned len = 0; len < sizeof(data); len++) {
+        for (unsigned start = 0; start < 4 && start + len <= sizeof(data); start++) {
+            const u8 *p = data + start;
+            CuAssertIntEquals(t, ref_crc8_msb(0x93, 0x07, p, len), Crc8Update(0x93, p, len));
+            CuAssertIntEquals(t, ref_crc8_msb(0, 0xD5, p, len), Crc8DvbS2Update(0, p, len));
+            CuAssertIntEquals(t, ref_crc16_msb(0xb5d2, 0x1021, p, len), Crc16CcittUpdate(0xb5d2, p, len));
+            CuAssertIntEquals(t, ref_crc16_frsky(p, len), Crc16FrskyUpdate(0, p, len));
+            CuAssertIntEquals(t, ref_crc32(p, len), Crc(p, len));
+        }
+    }
+}
+
+void TestCrcIncremental(CuTest *t)
+{
+    u8 data[40];
+    for (unsigned i = 0; i < sizeof(data); i++)
+        data[i] = i * 37 + 11;
+
+    for (unsigned split = 0; split <= sizeof(data); split++) {
+        unsigned rest = sizeof(data) - split;
+        CuAssertIntEquals(t, Crc8Update(0, data, sizeof(data)),
+                          Crc8Update(Crc8Update(0, data, split), data + split, rest));
+        CuAssertIntEquals(t, Crc16CcittUpdate(0, data, sizeof(data)),
+                          Crc16CcittUpdate(Crc16CcittUpdate(0, data, split), data + split, rest));
+        CuAssertIntEquals(t, Crc16FrskyUpdate(0, data, sizeof(data)),
+                          Crc16FrskyUpdate(Crc16FrskyUpdate(0, data, split), data + split, rest));
+        CuAssertIntEquals(t, Crc(data, sizeof(data)),
+                          CrcUpdate(Crc(data, split), data + split, rest));
+    }
+}
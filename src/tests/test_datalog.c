@@ -0,0 +1,158 @@
+#include "CuTest.h"
+
+static void read_datalog(u8 *buf, int len)
+{
+    FILE *f = fopen("datalog.bin", "rb");
+    fread(buf, len, 1, f);
+    fclose(f);
+}
+
+void TestDatalogBuffer(CuTest *t)
+{
+    #define REC_SIZE (DATALOG_RECORD_SIZE + 1)
+    volatile s32 *raw = MIXER_GetInputs();
+    u8 data[DATALOG_HEADER_SIZE + 2 * REC_SIZE];
+
+    memset(&Model, 0, sizeof(Model));
+    DATALOG_Init();
+    CuAssertTrue(t, fh != NULL);
+    DATALOG_Reset();
+    DATALOG_ApplyMask(DLOG_INPUTS, 1);  //AIL
+    Model.datalog.rate = DLOG_RATE_1SEC;
+    DATALOG_UpdateState();
+    Model.datalog.enable = 1;
+    raw[1] = CHAN_MAX_VALUE;
+
+    //Records stay in RAM until a block fills or logging stops
+    next_update = 0;
+    DATALOG_Update();
+    next_update = 0;
+    DATALOG_Update();
+    CuAssertIntEquals(t, 0, dlog_pos);
+    CuAssertIntEquals(t, sizeof(data), _pending());
+    CuAssertIntEquals(t, 16384 - sizeof(data), DATALOG_Remaining());
+
+    raw[1] = CHAN_MIN_VALUE;
+    DATALOG_Update();
+    CuAssertIntEquals(t, 0, _pending());
+    CuAssertIntEquals(t, sizeof(data), dlog_pos);
+
+    read_datalog(data, sizeof(data));
+    CuAssertIntEquals(t, DATALOG_VERSION, data[0]);
+    CuAssertIntEquals(t, TXID, data[1]);
+    CuAssertIntEquals(t, 1000, data[DATALOG_HEADER_SIZE - 2] | (data[DATALOG_HEADER_SIZE - 1] << 8));
+    u8 *rec = data + DATALOG_HEADER_SIZE;
+    for (int i = 0; i < 2; i++, rec += REC_SIZE) {
+        CuAssertIntEquals(t, 0xff, rec[0]);
+        CuAssertIntEquals(t, i, rec[1] | (rec[2] << 8));
+        CuAssertIntEquals(t, CLOCK_getms(), rec[3] | (rec[4] << 8) | (rec[5] << 16) | ((u32)rec[6] << 24));
+        CuAssertIntEquals(t, 100, rec[7]);
+    }
+
+    //Reopening the log continues after the last record
+    fclose(fh);
+    DATALOG_Init();
+    CuAssertIntEquals(t, sizeof(data), dlog_pos);
+
+    //While logging only whole, aligned blocks are written
+    raw[1] = CHAN_MAX_VALUE;
+    while (dlog_pos == sizeof(data)) {
+        next_update = 0;
+        DATALOG_Update();
+    }
+    CuAssertIntEquals(t, DATALOG_BLOCK_SIZE, dlog_pos);
+    CuAssertTrue(t, _pending() < REC_SIZE);
+
+    DATALOG_Reset();
+    fclose(fh);
+    fh = NULL;
+}
+
+void TestDatalogTick(CuTest *t)
+{
+    volatile s32 *raw = MIXER_GetInputs();
+
+    memset(&Model, 0, sizeof(Model));
+    DATALOG_Init();
+    DATALOG_Reset();
+    DATALOG_ApplyMask(DLOG_INPUTS, 1);  //AIL
+    Model.datalog.rate = DLOG_RATE_50MS;
+    DATALOG_UpdateState();
+    Model.datalog.enable = 1;
+    raw[1] = CHAN_MAX_VALUE;
+
+    //Fast rates are only sampled from the mixer tick
+    next_update = 0;
+    DATALOG_Update();
+    CuAssertIntEquals(t, 0, _pending());
+    DATALOG_Tick();
+    CuAssertIntEquals(t, DATALOG_HEADER_SIZE + REC_SIZE, _pending());
+    //Not due yet
+    DATALOG_Tick();
+    CuAssertIntEquals(t, DATALOG_HEADER_SIZE + REC_SIZE, _pending());
+
+    //The tick never writes to the file, records that don't fit are dropped
+    while (DATALOG_BUFSIZE - _pending() >= REC_SIZE) {
+        next_update = 0;
+        DATALOG_Tick();
+    }
+    u16 seq = sequence;
+    next_update = 0;
+    DATALOG_Tick();
+    CuAssertIntEquals(t, 0, dlog_pos);
+    CuAssertIntEquals(t, seq + 1, sequence);
+
+    //The main loop drains the ring
+    DATALOG_Update();
+    CuAssertIntEquals(t, DATALOG_BLOCK_SIZE, dlog_pos);
+    next_update = 0;
+    DATALOG_Tick();
+    CuAssertIntEquals(t, seq + 2, sequence);
+
+    DATALOG_Reset();
+    fclose(fh);
+    fh = NULL;
+}
+
+void TestDatalogFindPosV5(CuTest *t)
+{
+    //A version 5 header is 2 bytes shorter, the first record follows it directly
+    #define V5_HEADER_SIZE (DATALOG_HEADER_SIZE - 2)
+    #define V5_REC_SIZE (DATALOG_RECORD_SIZE + 1)
+    u8 saved[DATALOG_BLOCK_SIZE];
+    u8 data[V5_HEADER_SIZE + 2 * V5_REC_SIZE + 1];
+
+    FILE *f = fopen("datalog.bin", "r+b");
+    fread(saved, sizeof(saved), 1, f);
+    memset(data, 0, sizeof(data));
+    data[0] = 0x05;
+    data[1] = TXID;
+    data[2] = DLOG_RATE_1SEC;
+    data[3 + DATALOG_BYTE(DLOG_INPUTS)] = 1 << DATALOG_POS(DLOG_INPUTS);  //AIL
+    u8 *rec = data + V5_HEADER_SIZE;
+    for (int i = 0; i < 2; i++, rec += V5_REC_SIZE) {
+        rec[0] = 0xff;
+        rec[1] = 0x21 + i;  //sequence and timestamp must not look like markers
+        rec[2] = 0x01;
+        rec[3] = 0x44;
+        rec[4] = 0x33;
+        rec[5] = 0x22;
+        rec[6] = 0x11;
+        rec[7] = 100;
+    }
+    fseek(f, 0, SEEK_SET);
+    fwrite(data, sizeof(data), 1, f);
+    fclose(f);
+
+    memset(&Model, 0, sizeof(Model));
+    DATALOG_Init();
+    CuAssertTrue(t, fh != NULL);
+    CuAssertIntEquals(t, sizeof(data) - 1, dlog_pos);
+    CuAssertIntEquals(t, sizeof(data) - 1, ftell(fh));
+    fclose(fh);
+    fh = NULL;
+
+    f = fopen("datalog.bin", "r+b");
+    fwrite(saved, sizeof(saved), 1, f);
+    fclose(f);
+}
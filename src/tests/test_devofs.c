@@ -0,0 +1,463 @@
+#include "CuTest.h"
+#include <stdio.h>
+
+static FATFS test_fs;
+static struct index_entry test_index[64];
+
+static void devofs_format(unsigned index_size)
+{
+    for (int i = 0; i < SECTOR_COUNT; i++)
+        disk_erasep(i);
+    _write_sector_id(0, SECTORID_START);
+    df_set_index(test_index, index_size);
+    df_mount(&test_fs);
+}
+
+static void devofs_mkdir(const char *path)
+{
+    char name[13];
+    _find_parent_dir(_fs, path, name);
+    _create_file_or_dir(name, AM_DIR);
+}
+
+static void devofs_put(const char *path, const char *data)
+{
+    char name[13];
+    u16 written;
+    _find_parent_dir(_fs, path, name);
+    if (_find_file(_fs, name) == FR_OK)
+        df_open(path, O_CREAT);
+    else
+        _create_file_or_dir(name, AM_FILE);
+    df_write(data, strlen(data), &written);
+    df_close();
+}
+
+static int devofs_get(const char *path, char *buf, int len)
+{
+    u16 actual;
+    if (df_open(path, 0) != FR_OK)
+        return -1;
+    df_read(buf, len - 1, &actual);
+    buf[actual] = 0;
+    df_close();
+    return actual;
+}
+
+static void devofs_list(const char *path, char *out)
+{
+    DIR dir;
+    FILINFO fi;
+    out[0] = 0;
+    if (df_opendir(&dir, path) != FR_OK)
+        return;
+    while (df_readdir(&dir, &fi) == FR_OK) {
+        strcat(out, fi.fname);
+        strcat(out, " ");
+    }
+}
+
+void TestDevofsIndexLookup(CuTest *t)
+{
+    const char *names[] = {"tx.ini", "hardware.ini", "models/model1.ini", "models/model2.ini",
+                           "media/config.ini", "media/sound.ini", "datalog.bin"};
+    enum { NUM_NAMES = sizeof(names) / sizeof(names[0]) };
+    int addr[NUM_NAMES];
+    char buf[40];
+
+    devofs_format(64);
+    devofs_mkdir("models");
+    devofs_mkdir("media");
+    for (int i = 0; i < NUM_NAMES; i++)
+        devofs_put(names[i], names[i]);
+    CuAssertTrue(t, _index.valid);
+
+    // The index must find the same headers as a walk of the log
+    for (int scan = 0; scan < 2; scan++) {
+        _index.valid = ! scan;
+        for (int i = 0; i < NUM_NAMES; i++) {
+            CuAssertIntEquals(t, strlen(names[i]), devofs_get(names[i], buf, sizeof(buf)));
+            CuAssertStrEquals(t, names[i], buf);
+            if (scan)
+                CuAssertIntEquals(t, addr[i], _fs->file_addr);
+            else
+                addr[i] = _fs->file_addr;
+        }
+        CuAssertIntEquals(t, -1, devofs_get("models/model3.ini", buf, sizeof(buf)));
+        CuAssertIntEquals(t, -1, devofs_get("model1.ini", buf, sizeof(buf)));
+        CuAssertIntEquals(t, -1, devofs_get("media", buf, sizeof(buf)));
+    }
+    _index.valid = 1;
+}
+
+void TestDevofsIndexReuse(CuTest *t)
+{
+    char buf[40], data[20];
+
+    devofs_format(8);
+    devofs_put("a.ini", "a");
+    devofs_put("b.ini", "b");
+    devofs_put("c.ini", "c");
+    // Each rewrite and recreate leaves a deleted entry behind, which must be
+    // reused or the 8 entries would run out after a few rounds
+    for (int i = 0; i < 40; i++) {
+        sprintf(data, "b%d", i);
+        devofs_put("b.ini", data);
+        sprintf(data, "c%d", i);
+        CuAssertIntEquals(t, FR_OK, df_unlink("c.ini"));
+        CuAssertIntEquals(t, -1, devofs_get("c.ini", buf, sizeof(buf)));
+        devofs_put("c.ini", data);
+    }
+    CuAssertTrue(t, _index.valid);
+    int live = 0;
+    for (int i = 0; i < 8; i++)
+        live += test_index[i].addr != 0;
+    CuAssertIntEquals(t, 3, live);
+    devofs_get("a.ini", buf, sizeof(buf));
+    CuAssertStrEquals(t, "a", buf);
+    devofs_get("b.ini", buf, sizeof(buf));
+    CuAssertStrEquals(t, "b39", buf);
+    devofs_get("c.ini", buf, sizeof(buf));
+    CuAssertStrEquals(t, "c39", buf);
+}
+
+void TestDevofsIndexOverflow(CuTest *t)
+{
+    char name[13], buf[40], list[100];
+
+    devofs_format(4);
+    for (int i = 0; i < 6; i++) {
+        sprintf(name, "f%d.ini", i);
+        devofs_put(name, name);
+    }
+    // Too many files for the table: everything is found by scanning
+    CuAssertTrue(t, ! _index.valid);
+    for (int i = 0; i < 6; i++) {
+        sprintf(name, "f%d.ini", i);
+        CuAssertIntEquals(t, 6, devofs_get(name, buf, sizeof(buf)));
+        CuAssertStrEquals(t, name, buf);
+    }
+    devofs_list("/", list);
+    CuAssertStrEquals(t, "f0.ini f1.ini f2.ini f3.ini f4.ini f5.ini ", list);
+
+    // A table that fits is used again from the next mount
+    df_set_index(test_index, 16);
+    df_mount(&test_fs);
+    CuAssertTrue(t, _index.valid);
+    devofs_list("/", list);
+    CuAssertStrEquals(t, "f0.ini f1.ini f2.ini f3.ini f4.ini f5.ini ", list);
+    CuAssertIntEquals(t, 6, devofs_get("f5.ini", buf, sizeof(buf)));
+}
+
+void TestDevofsReaddirOrder(CuTest *t)
+{
+    char list[100];
+
+    devofs_format(64);
+    devofs_put("a.ini", "a");
+    devofs_mkdir("models");
+    devofs_put("b.ini", "b");
+    devofs_put("models/x.ini", "x");
+    devofs_put("c.ini", "c");
+    devofs_put("a.ini", "a2");  // moves to the end of the log
+    devofs_put("models/y.ini", "y");
+
+    // Entries come back in log order, as a walk of the log returns them
+    for (int scan = 0; scan < 2; scan++) {
+        _index.valid = ! scan;
+        devofs_list("/", list);
+        CuAssertStrEquals(t, "models b.ini c.ini a.ini ", list);
+        devofs_list("models", list);
+        CuAssertStrEquals(t, "x.ini y.ini ", list);
+    }
+    _index.valid = 1;
+
+    df_unlink("b.ini");
+    devofs_list("/", list);
+    CuAssertStrEquals(t, "models c.ini a.ini ", list);
+    df_compact();
+    CuAssertTrue(t, _index.valid);
+    devofs_list("/", list);
+    CuAssertStrEquals(t, "models c.ini a.ini ", list);
+    devofs_list("models", list);
+    CuAssertStrEquals(t, "x.ini y.ini ", list);
+}
+
+/* Compaction, with the power cut at every flash write and erase of the run */
+extern int test_flash_cut;
+void STORAGE_CacheReset();
+
+static const char * const compact_names[] = {"datalog.bin", "tx.ini", "models/model1.ini",
+                                             "models/model2.ini", "hardware.ini", "models/model3.ini"};
+enum { NUM_COMPACT_FILES = sizeof(compact_names) / sizeof(compact_names[0]) };
+
+static int compact_data(char *buf, int file, int version)
+{
+    int len = 600 + file * 60;
+    for (int i = 0; i < len; i++)
+        buf[i] = 'a' + (file * 7 + version * 3 + i) % 26;
+    buf[len] = 0;
+    return len;
+}
+
+static void compact_setup(int *version)
+{
+    char data[1024];
+    devofs_format(64);
+    for (int i = 0; i < NUM_COMPACT_FILES; i++) {
+        if (i == 2)
+            devofs_mkdir("models");
+        version[i] = 0;
+        compact_data(data, i, 0);
+        devofs_put(compact_names[i], data);
+    }
+    // Leave deleted copies of the models all over the log
+    for (int round = 1; round <= 4; round++) {
+        for (int i = 2; i < NUM_COMPACT_FILES; i++) {
+            if (i == 4)
+                continue;
+            version[i] = round;
+            compact_data(data, i, round);
+            devofs_put(compact_names[i], data);
+        }
+    }
+}
+
+static int devofs_count(const char *path, const char *name)
+{
+    DIR dir;
+    FILINFO fi;
+    int count = 0;
+    if (df_opendir(&dir, path) != FR_OK)
+        return -1;
+    while (df_readdir(&dir, &fi) == FR_OK)
+        count += ! name || strcmp(fi.fname, name) == 0;
+    return count;
+}
+
+static void compact_check(CuTest *t, const int *version)
+{
+    char buf[1024], expect[1024];
+    int valid = _index.valid;
+    for (int scan = 0; scan < 2; scan++) {
+        _index.valid = valid && ! scan;
+        for (int i = 0; i < NUM_COMPACT_FILES; i++) {
+            int len = compact_data(expect, i, version[i]);
+            CuAssertIntEquals(t, len, devofs_get(compact_names[i], buf, sizeof(buf)));
+            CuAssertStrEquals(t, expect, buf);
+            // Listed exactly once
+            const char *name = strchr(compact_names[i], '/');
+            CuAssertIntEquals(t, 1, name ? devofs_count("models", name + 1) : devofs_count("/", compact_names[i]));
+        }
+        CuAssertIntEquals(t, 4, devofs_count("/", NULL));
+        CuAssertIntEquals(t, 3, devofs_count("models", NULL));
+    }
+    _index.valid = valid;
+}
+
+//Live objects in the log from sector on, before a mount has tidied it up
+static int count_live(int sector)
+{
+    struct file_header fh;
+    int count = 0;
+    int addr = sector * SECTOR_SIZE + 1;
+    _spiread(&fh, addr, sizeof(fh));
+    while (fh.type != FILEOBJ_NONE) {
+        count += FILE_LIVE(fh);
+        addr = _get_addr(addr, sizeof(fh) + FILE_SIZE(fh));
+        _spiread(&fh, addr, sizeof(fh));
+    }
+    return count;
+}
+
+static void compact_finish(CuTest *t)
+{
+    while (_compact_run(STEP_SIZE))
+        ;
+    CuAssertIntEquals(t, 0, _log.read);
+}
+
+void TestDevofsCompactPowerCut(CuTest *t)
+{
+    static u8 image[SECTOR_COUNT * SECTOR_SIZE];
+    int version[NUM_COMPACT_FILES];
+    int recovery_sector;
+    int resumed = 0, duplicated = 0, start_moved = 0, two_starts = 0;
+
+    compact_setup(version);
+    int free_before = _get_free_space();
+    for (int i = 0; i < SECTOR_COUNT; i++)
+        disk_readp(image + i * SECTOR_SIZE, i, 0, SECTOR_SIZE);
+
+    // Count the writes and erases of an uninterrupted run
+    test_flash_cut = 1 << 30;
+    CuAssertTrue(t, _compact_begin());
+    compact_finish(t);
+    STORAGE_CacheReset();
+    int ops = (1 << 30) - test_flash_cut;
+    test_flash_cut = -1;
+    CuAssertTrue(t, ops > 20);
+
+    for (int cut = 0; cut <= ops; cut++) {
+        for (int i = 0; i < SECTOR_COUNT; i++) {
+            disk_erasep(i);
+            disk_writep_rand(image + i * SECTOR_SIZE, i, 0, SECTOR_SIZE);
+        }
+        STORAGE_CacheReset();
+        df_mount(&test_fs);
+        // Nothing runs once the power is gone
+        test_flash_cut = cut;
+        if (_compact_begin()) {
+            while (test_flash_cut && _compact_run(1))
+                ;
+        }
+        // whatever the cache still held is lost too
+        STORAGE_CacheReset();
+        test_flash_cut = -1;
+
+        int start = _find_start_sector(&recovery_sector);
+        CuAssertTrue(t, start >= 0);
+        two_starts += recovery_sector >= 0;
+        duplicated += count_live(start) > NUM_COMPACT_FILES + 1;
+        df_mount(&test_fs);
+        resumed += _log.read != 0;
+        start_moved += recovery_sector < 0 && _log.read && start != _log.split / SECTOR_SIZE
+                       && _mountfs->start_sector != start;
+        compact_check(t, version);
+        int free = _get_free_space();
+        int reclaim = _log.reclaim;
+        df_mount(&test_fs);
+        CuAssertIntEquals(t, free, _get_free_space());
+        CuAssertIntEquals(t, reclaim, _log.reclaim);
+
+        // The run picks up from where it stopped, or starts over if it never began
+        if (! _log.read)
+            CuAssertTrue(t, _compact_begin());
+        compact_finish(t);
+        compact_check(t, version);
+        CuAssertTrue(t, _get_free_space() > free_before);
+        free = _get_free_space();
+        reclaim = _log.reclaim;
+        df_mount(&test_fs);
+        CuAssertIntEquals(t, free, _get_free_space());
+        CuAssertIntEquals(t, reclaim, _log.reclaim);
+        compact_check(t, version);
+    }
+    // Cut after a mark (the run resumes at the next mount), after a copy but
+    // before the original was deleted, between a mark and moving the START
+    // sector, and with two START sectors
+    CuAssertTrue(t, resumed > 0);
+    CuAssertTrue(t, duplicated > 0);
+    CuAssertTrue(t, start_moved > 0);
+    CuAssertTrue(t, two_starts > 0);
+}
+
+void TestDevofsCompactWriteInPlace(CuTest *t)
+{
+    char data[1024], patch[300];
+    int version[NUM_COMPACT_FILES];
+
+    compact_setup(version);
+    // datalog.bin, at the head of the log, is updated in place while compaction copies it
+    CuAssertIntEquals(t, FR_OK, df_open("datalog.bin", 0));
+    CuAssertTrue(t, _compact_begin());
+    _compact_run(1);    // header
+    _compact_run(1);    // first COPY_SIZE bytes of data
+    CuAssertIntEquals(t, _fs->file_addr, _log.read);
+    CuAssertIntEquals(t, COPY_SIZE, _log.copy_pos);
+    memset(patch, 'Z', sizeof(patch));
+    u16 written;
+    df_lseek(100);
+    df_write(patch, sizeof(patch), &written);
+    CuAssertIntEquals(t, sizeof(patch), written);
+    compact_finish(t);
+    df_lseek(0);
+    int len = compact_data(data, 0, 0);
+    memset(data + 100, 'Z', sizeof(patch));
+    char buf[1024];
+    u16 actual;
+    df_read(buf, len, &actual);
+    buf[actual] = 0;
+    df_close();
+    CuAssertStrEquals(t, data, buf);
+    CuAssertIntEquals(t, len, devofs_get("datalog.bin", buf, sizeof(buf)));
+    CuAssertStrEquals(t, data, buf);
+}
+
+/* A log that has filled every sector and wrapped round with no free header
+ * left, as when the power is cut during a save that ran to the end of the
+ * flash, then the power cut at every flash write and erase of the next save */
+static void full_log_image()
+{
+    struct file_header fh;
+    char data[SECTOR_SIZE];
+    for (int i = 0; i < SECTOR_COUNT; i++) {
+        disk_erasep(i);
+        _write_sector_id(i, i ? SECTORID_DATA : SECTORID_START);
+        // One object filling each sector; the last, still being written, leads back to the start
+        int len = SECTOR_SIZE - 1 - sizeof(fh);
+        memset(&fh, 0, sizeof(fh));
+        fh.type = i == SECTOR_COUNT - 1 ? FILEOBJ_WRITE : i % 2 ? FILEOBJ_FILE : FILEOBJ_FILEDEL;
+        sprintf(fh.name, "f%d", i);
+        fh.name[8] = 'i'; fh.name[9] = 'n'; fh.name[10] = 'i';
+        fh.size2 = len >> 8;
+        fh.size3 = len;
+        memset(data, 'a' + i, len);
+        disk_writep_rand((u8 *)&fh, i, 1, sizeof(fh));
+        disk_writep_rand((u8 *)data, i, 1 + sizeof(fh), len);
+    }
+    STORAGE_CacheReset();
+}
+
+static void full_log_check(CuTest *t)
+{
+    static char buf[SECTOR_SIZE];
+    char name[13];
+    for (int i = 1; i < SECTOR_COUNT - 1; i += 2) {
+        sprintf(name, "f%d.ini", i);
+        CuAssertIntEquals(t, SECTOR_SIZE - 1 - sizeof(struct file_header), devofs_get(name, buf, sizeof(buf)));
+        CuAssertIntEquals(t, 'a' + i, buf[0]);
+        CuAssertIntEquals(t, 'a' + i, buf[SECTOR_SIZE - 2 - sizeof(struct file_header)]);
+    }
+}
+
+void TestDevofsFullLogPowerCut(CuTest *t)
+{
+    char buf[40];
+
+    full_log_image();
+    df_set_index(test_index, 64);
+    CuAssertIntEquals(t, FR_OK, df_mount(&test_fs));
+    CuAssertIntEquals(t, 0, _get_free_space());
+    CuAssertIntEquals(t, (SECTOR_COUNT / 2 + 1) * (SECTOR_SIZE - 1), _log.reclaim);
+    full_log_check(t);
+
+    // Count the writes and erases of a save that compacts the log
+    test_flash_cut = 1 << 30;
+    devofs_put("new.ini", "new");
+    STORAGE_CacheReset();
+    int ops = (1 << 30) - test_flash_cut;
+    test_flash_cut = -1;
+    CuAssertTrue(t, ops > SECTOR_COUNT);
+
+    for (int cut = 0; cut <= ops; cut++) {
+        full_log_image();
+        df_mount(&test_fs);
+        test_flash_cut = cut;
+        devofs_put("new.ini", "new");
+        STORAGE_CacheReset();
+        test_flash_cut = -1;
+        // A blocking compaction can lose files to a cut, but the mount always finishes
+        CuAssertIntEquals(t, FR_OK, df_mount(&test_fs));
+        int free = _get_free_space();
+        int reclaim = _log.reclaim;
+        df_mount(&test_fs);
+        CuAssertIntEquals(t, free, _get_free_space());
+        CuAssertIntEquals(t, reclaim, _log.reclaim);
+    }
+    // The save that wasn't cut compacted the log to make room
+    full_log_check(t);
+    CuAssertTrue(t, _get_free_space() > 0);
+    CuAssertIntEquals(t, 3, devofs_get("new.ini", buf, sizeof(buf)));
+    CuAssertStrEquals(t, "new", buf);
+}
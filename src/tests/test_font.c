@@ -0,0 +1,64 @@
+#include "CuTest.h"
+
+void TestFontCache(CuTest* t)
+{
+    const char str[] = "Mixer 0123 !@#";
+    u8 buf[CHAR_BUF_SIZE], cached[CHAR_BUF_SIZE];
+    u8 width, cached_width;
+    u32 begin, end;
+    u8 old_font = LCD_SetFont(0);
+
+    CuAssertIntEquals(t, 1, open_font("15normal"));
+    for (const char *c = str; *c; c++) {
+        //Read the glyph straight from the font file
+        get_char_range(*c, &begin, &end);
+        fseek(font_fh, begin, SEEK_SET);
+        fread(buf, end - begin, 1, font_fh);
+        width = (end - begin) / row_bytes();
+
+        //1st read fills the cache, 2nd is served from it
+        char_read(cached, *c, &cached_width);
+        char_read(cached, *c, &cached_width);
+        CuAssertIntEquals(t, width, cached_width);
+        CuAssertIntEquals(t, width, get_width(*c));
+        CuAssertTrue(t, memcmp(buf, cached, end - begin) == 0);
+    }
+    //Glyphs are kept per font
+    width = get_width('M');
+    CuAssertIntEquals(t, 1, open_font("23bold"));
+    CuAssertIntEquals(t, 23, get_height());
+    CuAssertTrue(t, get_width('M') > width);
+    CuAssertIntEquals(t, 1, open_font("15normal"));
+    CuAssertIntEquals(t, width, get_width('M'));
+    CuAssertIntEquals(t, 0, open_font("nofont"));
+    LCD_SetFont(old_font);
+}
+
+void TestFontCacheReset(CuTest* t)
+{
+    u8 old_font = LCD_SetFont(0);
+
+    CuAssertIntEquals(t, 1, open_font("23bold"));
+    u8 bold_width = get_width('M');
+    CuAssertIntEquals(t, 1, open_font("15normal"));
+    u8 width = get_width('M'), height = get_height();
+    CuAssertTrue(t, bold_width != width);
+
+    //Replace 15normal.fon behind the cache, as the PC may over USB
+    rename("media/15normal.fon", "media/15normal.tmp");
+    rename("media/23bold.fon", "media/15normal.fon");
+    CuAssertIntEquals(t, 1, open_font("15normal"));
+    CuAssertIntEquals(t, width, get_width('M'));
+    FONT_CacheReset();
+    CuAssertIntEquals(t, 23, get_height());
+    CuAssertIntEquals(t, bold_width, get_width('M'));
+    CuAssertIntEquals(t, 1, open_font("15normal"));
+    CuAssertIntEquals(t, 23, get_height());
+
+    rename("media/15normal.fon", "media/23bold.fon");
+    rename("media/15normal.tmp", "media/15normal.fon");
+    FONT_CacheReset();
+    CuAssertIntEquals(t, height, get_height());
+    CuAssertIntEquals(t, width, get_width('M'));
+    LCD_SetFont(old_font);
+}
@@ -43,6 +43,91 @@ void TestEvalMixers(CuTest *t)
     CuAssertIntEquals(t, NUM_MIXERS -1, rawdata[3 + NUM_INPUTS]);
 }
 
+void TestCompileMixers(CuTest *t)
+{
+    s32 rawdata[NUM_SOURCES + 1] = {0};
+    memset(&Model, 0, sizeof(Model));
+    Transmitter.mode = MODE_1;
+    Model.trims[0].src = INP_AILERON;
+    Model.trims[0].step = 10;
+    Model.trims[0].value[0] = 10;
+    Model.mixers[0].src = 0x80 | INP_AILERON;
+    Model.mixers[0].dest = 0;
+    Model.mixers[0].scalar = 50;
+    MIXER_SET_APPLY_TRIM(&Model.mixers[0], 1);
+    Model.mixers[1].src = INP_ELEVATOR;
+    Model.mixers[1].sw = 0x80 | INP_RUDDER;
+    Model.mixers[1].dest = 0;
+    Model.mixers[1].scalar = 100;
+    MIXER_SET_MUX(&Model.mixers[1], MUX_ADD);
+    MIXER_CompileMixers();
+
+    raw[INP_AILERON] = 4000;
+    raw[INP_ELEVATOR] = 2000;
+    raw[INP_RUDDER] = 100;
+    rawdata[INP_AILERON] = 4000;
+    rawdata[INP_ELEVATOR] = 2000;
+    rawdata[INP_RUDDER] = 100;
+    run_mixer_program(raw, 1);
+    MIXER_EvalMixers(rawdata);
+    CuAssertIntEquals(t, -2000 - 1000, raw[NUM_INPUTS + 1]);
+    CuAssertIntEquals(t, rawdata[NUM_INPUTS + 1], raw[NUM_INPUTS + 1]);
+
+    raw[INP_RUDDER] = -100;
+    rawdata[INP_RUDDER] = -100;
+    run_mixer_program(raw, 1);
+    MIXER_EvalMixers(rawdata);
+    CuAssertIntEquals(t, -2000 - 1000 + 2000, raw[NUM_INPUTS + 1]);
+    CuAssertIntEquals(t, rawdata[NUM_INPUTS + 1], raw[NUM_INPUTS + 1]);
+
+    // Scalars are read live, so in-place edits don't need a recompile
+    Model.mixers[0].scalar = 100;
+    run_mixer_program(raw, 1);
+    CuAssertIntEquals(t, -4000 - 1000 + 2000, raw[NUM_INPUTS + 1]);
+}
+
+void TestCurveLut(CuTest *t)
+{
+    struct Curve curves[] = {
+        { .type = CURVE_EXPO, .points = {40, -60}},
+        { .type = CURVE_EXPO, .points = {100, 100}},
+        { .type = 0x80 | CURVE_3POINT, .points = {-100, 20, 100}},
+        { .type = 0x80 | CURVE_5POINT, .points = {-100, -20, 0, 60, 100}},
+        { .type = 0x80 | CURVE_7POINT, .points = {0, 40, 60, 70, 60, 40, 0}},
+        { .type = 0x80 | CURVE_13POINT, .points = {-100, -80, -50, -40, -20, 0, 10, 30, 20, 40, 60, 90, 100}},
+    };
+    CURVE_ClearLuts();
+    for (unsigned i = 0; i < sizeof(curves) / sizeof(curves[0]); i++) {
+        int lut = CURVE_BuildLut(&curves[i]);
+        CuAssertTrue(t, lut >= 0);
+        for (s32 x = CHAN_MIN_VALUE - 100; x <= CHAN_MAX_VALUE + 100; x += 7) {
+            s32 exact = CURVE_Evaluate(x, &curves[i]);
+            s32 fast = CURVE_EvaluateLut(x, &curves[i], lut);
+            CuAssertTrue(t, abs(exact - fast) <= CURVE_LUT_TOLERANCE);
+        }
+        CuAssertIntEquals(t, CURVE_Evaluate(0, &curves[i]), CURVE_EvaluateLut(0, &curves[i], lut));
+    }
+    //Identical curves share a table, linear curves don't need one
+    CuAssertIntEquals(t, CURVE_BuildLut(&curves[0]), CURVE_BuildLut(&curves[0]));
+    struct Curve linear = { .type = CURVE_3POINT, .points = {-100, 20, 100}};
+    CuAssertIntEquals(t, -1, CURVE_BuildLut(&linear));
+
+    //A full-scale swing between two points is the worst case
+    struct Curve steep = { .type = 0x80 | CURVE_13POINT,
+                           .points = {-100, -100, -100, -100, -100, -100, 100, 100, 100, 100, 100, 100, 100}};
+    int lut = CURVE_BuildLut(&steep);
+    for (s32 x = CHAN_MIN_VALUE; x <= CHAN_MAX_VALUE; x += 7)
+        CuAssertTrue(t, abs(CURVE_Evaluate(x, &steep) - CURVE_EvaluateLut(x, &steep, lut)) <= CURVE_LUT_STEEP_TOLERANCE);
+
+    //Editing the curve falls back to the exact calculation once it is checked
+    lut = CURVE_BuildLut(&curves[2]);
+    CuAssertIntEquals(t, lut, CURVE_CheckLut(&curves[2], lut));
+    curves[2].points[1] = -50;
+    lut = CURVE_CheckLut(&curves[2], lut);
+    CuAssertIntEquals(t, -1, lut);
+    CuAssertIntEquals(t, CURVE_Evaluate(3000, &curves[2]), CURVE_EvaluateLut(3000, &curves[2], lut));
+}
+
 void TestMixerMapChannel(CuTest *t)
 {
      unsigned channels[] = {INP_THROTTLE, INP_ELEVATOR, INP_AILERON, INP_RUDDER, 5};
@@ -156,6 +241,7 @@ void TestCalcChannels(CuTest *t)
     Model.templates[5] = MIXERTEMPLATE_CYC1;
     Model.templates[6] = MIXERTEMPLATE_CYC2;
     Model.templates[7] = MIXERTEMPLATE_CYC3;
+    MIXER_CompileMixers();
     MIXER_CalcChannels();
     s32 expected[NUM_OUT_CHANNELS] = {0, 0, 0, 0, 0, 1000, 800, 600, 0, 0, 0, 0, 0, 0, 0, 0};
     for (int i = 0; i < NUM_OUT_CHANNELS; i++) {
@@ -163,6 +249,56 @@ void TestCalcChannels(CuTest *t)
     }
 }
 
+void TestCalcChannelsIncremental(CuTest *t)
+{
+    memset(&Model, 0, sizeof(Model));
+    memset((s32 *)raw, 0, sizeof(raw));
+    Transmitter.mode = MODE_1;
+    TEST_CHAN_SetChannelValue(INP_AILERON, 2000);
+    TEST_CHAN_SetChannelValue(INP_ELEVATOR, 4000);
+    Model.mixers[0].src = INP_AILERON;
+    Model.mixers[0].dest = 0;
+    Model.mixers[0].scalar = 100;
+    Model.mixers[1].src = INP_ELEVATOR;
+    Model.mixers[1].dest = 1;
+    Model.mixers[1].scalar = 100;
+    for (int i = 0; i < NUM_OUT_CHANNELS; i++) {
+        Model.limits[i].servoscale = 100;
+        Model.limits[i].max = 150;
+        Model.limits[i].min = 150;
+    }
+    MIXER_CompileMixers();
+    MIXER_CalcChannels();
+    CuAssertIntEquals(t, 2000, Channels[0]);
+    CuAssertIntEquals(t, 4000, Channels[1]);
+
+    //Unchanged inputs leave the outputs alone
+    Channels[0] = 1234;
+    Channels[1] = 1234;
+    TEST_CHAN_SetChannelValue(INP_ELEVATOR, -4000);
+    MIXER_CalcChannels();
+    CuAssertIntEquals(t, 1234, Channels[0]);
+    CuAssertIntEquals(t, -4000, Channels[1]);
+
+    //Trim changes are tracked too
+    Model.trims[0].src = INP_AILERON;
+    Model.trims[0].step = 10;
+    MIXER_SET_APPLY_TRIM(&Model.mixers[0], 1);
+    MIXER_CompileMixers();
+    MIXER_CalcChannels();
+    Model.trims[0].value[0] = 10;
+    MIXER_CalcChannels();
+    CuAssertIntEquals(t, 3000, Channels[0]);
+
+    //In-place edits are picked up once the config generation moves
+    Model.mixers[1].scalar = 50;
+    MIXER_CalcChannels();
+    CuAssertIntEquals(t, -4000, Channels[1]);
+    CONFIG_MarkChanged();
+    MIXER_CalcChannels();
+    CuAssertIntEquals(t, -2000, Channels[1]);
+}
+
 void TestGetInputs(CuTest *t)
 {
     CuAssertPtrEquals(t, (void *)raw, (void *)MIXER_GetInputs());
@@ -585,6 +721,14 @@ void TestUpdateTrim(CuTest *t)
     MIXER_UpdateTrim(CHAN_ButtonMask(neg), BUTTON_LONGPRESS, NULL);
     CuAssertIntEquals(t, -100, Model.trims[0].value[0]);
     CuAssertIntEquals(t, 1, TEST_Button_InterruptLongPress());
+
+    //Only a trim that moves marks the config changed
+    u16 generation = config_generation;
+    MIXER_UpdateTrim(CHAN_ButtonMask(neg), 0, NULL);
+    CuAssertIntEquals(t, generation, config_generation);
+    MIXER_UpdateTrim(CHAN_ButtonMask(pos), 0, NULL);
+    CuAssertIntEquals(t, -99, Model.trims[0].value[0]);
+    CuAssertTrue(t, config_generation != generation);
 }
 
 void TestTrimAsSwitch(CuTest *t) 
@@ -31,6 +31,108 @@ void TestModelLoadSaveWithLoc(CuTest *t)
     CuAssertTrue(t, memcmp(&ValidateModel, &Model, sizeof(Model)) == 0);
 }
 
+void TestModelCache(CuTest *t)
+{
+    struct Model ParsedModel;
+
+    CONFIG_ResetModel();
+    strcpy(Model.name, "CacheTest");
+    CONFIG_WriteModel(3);
+    remove("models/model3.bin");
+    //1st read parses the ini and writes the cache, 2nd read uses the cache
+    CONFIG_ReadModel(3);
+    memcpy(&ParsedModel, &Model, sizeof(Model));
+    CuAssertTrue(t, fexists("models/model3.bin"));
+    CONFIG_ReadModel(3);
+    CuAssertStrEquals(t, "CacheTest", Model.name);
+    CuAssertTrue(t, memcmp(&ParsedModel, &Model, sizeof(Model)) == 0);
+
+    //A changed ini file invalidates the cache
+    strcpy(Model.name, "CacheTest2");
+    CONFIG_WriteModel(3);
+    CONFIG_ReadModel(3);
+    CuAssertStrEquals(t, "CacheTest2", Model.name);
+
+    //So do Transmitter settings the parser depends on
+    u32 crc = ini_file_crc("models/model3.ini");
+    CuAssertIntEquals(t, 1, read_model_cache(3, crc));
+    u8 language = Transmitter.language;
+    Transmitter.language = language + 1;
+    CuAssertIntEquals(t, 0, read_model_cache(3, crc));
+    Transmitter.language = language;
+    srcsize_t ignore_src = Transmitter.ignore_src;
+    Transmitter.ignore_src ^= 1;
+    CuAssertIntEquals(t, 0, read_model_cache(3, crc));
+    Transmitter.ignore_src = ignore_src;
+    CuAssertIntEquals(t, 1, read_model_cache(3, crc));
+}
+
+#if MODEL_CATALOG_SIZE
+void TestModelCatalog(CuTest *t)
+{
+    const struct ModelCatalogEntry *entry;
+
+    CONFIG_ResetModel();
+    strcpy(Model.name, "CatalogTest");
+    strcpy(Model.icon, "modelico/test.bmp");
+    Model.type = MODELTYPE_PLANE;
+    Model.protocol = PROTOCOL_DEVO;
+    CONFIG_WriteModel(4);
+    CONFIG_ModelCatalogReset();
+    CuAssertTrue(t, CONFIG_ModelCount() >= 4);
+    entry = CONFIG_GetModelCatalog(4);
+    CuAssertPtrNotNull(t, entry);
+    CuAssertStrEquals(t, "CatalogTest", entry->name);
+    CuAssertStrEquals(t, "test.bmp", entry->icon);
+    CuAssertIntEquals(t, MODELTYPE_PLANE, entry->type);
+    CuAssertIntEquals(t, PROTOCOL_DEVO, entry->protocol);
+
+    //Marked clean once every entry has been checked
+    for (int i = 1; i <= CONFIG_ModelCount(); i++)
+        CONFIG_GetModelCatalog(i);
+    CONFIG_ModelCatalogFlush();
+    catalog.loaded = 0;
+    CONFIG_ModelCount();
+    CuAssertIntEquals(t, 1, catalog.hdr.clean);
+
+    //and then trusted as it is after a reload
+    FILE *fh = fopen("models/model4.ini", "w");
+    fprintf(fh, "name=Edited\ntype=heli\n[radio]\nprotocol=None\n");
+    fclose(fh);
+    catalog.loaded = 0;
+    CuAssertStrEquals(t, "CatalogTest", CONFIG_GetModelCatalog(4)->name);
+
+    //After USB access an entry is checked against its ini and rebuilt, but
+    //only written once the list is closed, not while it is drawn
+    CONFIG_ModelCatalogReset();
+    entry = CONFIG_GetModelCatalog(4);
+    CuAssertStrEquals(t, "Edited", entry->name);
+    CuAssertStrEquals(t, "", entry->icon);
+    CuAssertIntEquals(t, MODELTYPE_HELI, entry->type);
+    CuAssertIntEquals(t, PROTOCOL_NONE, entry->protocol);
+    CuAssertIntEquals(t, 1, catalog.dirty);
+    CONFIG_ModelCatalogFlush();
+    CuAssertIntEquals(t, 0, catalog.dirty);
+
+    //A save that leaves the listed fields alone doesn't rewrite the catalog
+    CONFIG_ResetModel();
+    CONFIG_WriteModel(4);
+    u32 ini_crc = catalog.entry[3].ini_crc;
+    Model.fixed_id = 1234;
+    CONFIG_WriteModel(4);
+    CuAssertTrue(t, catalog.entry[3].ini_crc != ini_crc);
+    struct ModelCatalogEntry stored;
+    fh = fopen(MODEL_CATALOG_FILE, "r");
+    fseek(fh, sizeof(struct model_catalog_hdr) + 3 * sizeof(stored), SEEK_SET);
+    CuAssertIntEquals(t, 1, fread(&stored, sizeof(stored), 1, fh));
+    fclose(fh);
+    CuAssertIntEquals(t, ini_crc, stored.ini_crc);
+
+    CONFIG_ResetModel();
+    CONFIG_WriteModel(4);
+}
+#endif
+
 void TestModelChange(CuTest *t)
 {
     CONFIG_ResetModel();
@@ -38,3 +140,39 @@ void TestModelChange(CuTest *t)
 
     CuAssertTrue(t, CONFIG_IsModelChanged());
 }
+
+void TestCrc(CuTest *t)
+{
+    // Standard CRC-32 check value
+    CuAssertIntEquals(t, 0xCBF43926, Crc("123456789", 9));
+    CuAssertIntEquals(t, 0, Crc("", 0));
+    CuAssertIntEquals(t, Crc("123456789", 9), CrcUpdate(Crc("1234", 4), "56789", 5));
+}
+
+void TestSourceNames(CuTest *t)
+{
+    char name[20], inv[21];
+    unsigned val;
+    const char *alias;
+
+    CONFIG_ReadLang(0);
+    for (unsigned i = 0; i <= NUM_SOURCES; i++) {
+        INPUT_SourceNameReal(name, i);
+        CuAssertIntEquals(t, i, get_source("test", name));
+        sprintf(inv, "!%s", name);
+        CuAssertIntEquals(t, 0x80 | i, get_source("test", inv));
+    }
+    CuAssertIntEquals(t, INP_RUD_DR1, get_source("test", "rud_dr1"));
+    CuAssertIntEquals(t, 1, get_source("test", "RIGHT_H"));
+    for (unsigned i = 0; (alias = INPUT_MapSourceName(i, &val)); i++)
+        CuAssertIntEquals(t, val, get_source("test", alias));
+    CuAssertIntEquals(t, 0, get_source("test", "NoSuchSource"));
+
+    CuAssertIntEquals(t, INP_FMOD0, get_abbrev_source("fmode"));
+    CuAssertIntEquals(t, INP_THROTTLE, get_abbrev_source("thr"));
+    CuAssertIntEquals(t, -1, get_abbrev_source("FMODE1"));
+
+    for (unsigned i = 0; i <= NUM_TX_BUTTONS; i++)
+        CuAssertIntEquals(t, i, get_button("test", INPUT_ButtonName(i)));
+    CuAssertIntEquals(t, 0, get_button("test", "NoSuchButton"));
+}
@@ -32,3 +32,35 @@ void TestMusic(CuTest *t)
         CuAssertTrue(t, abs(get_freq(i) - note_map[i].note) < 8);
     }
 }
+
+void TestSoundTable(CuTest *t)
+{
+    u8 old_volume = Transmitter.volume;
+    Transmitter.volume = 10;
+    MUSIC_LoadSounds();
+    CuAssertIntEquals(t, 1, sounds_valid);
+
+    // [startup] is volume=30 followed by three notes
+    CuAssertIntEquals(t, 0, MUSIC_GetSound(MUSIC_STARTUP));
+    CuAssertIntEquals(t, 4, num_notes);
+    CuAssertIntEquals(t, 30, Volume);
+    CuAssertIntEquals(t, 3, notes[0].duration);
+    CuAssertIntEquals(t, get_note("g2"), notes[1].note);
+    CuAssertIntEquals(t, 10, notes[1].duration);
+    CuAssertIntEquals(t, get_note("c4"), notes[3].note);
+
+    // [volume] is volume=100 followed by a single d2
+    CuAssertIntEquals(t, 0, MUSIC_GetSound(MUSIC_VOLUME));
+    CuAssertIntEquals(t, 2, num_notes);
+    CuAssertIntEquals(t, 100, Volume);
+    CuAssertIntEquals(t, get_note("d2"), notes[1].note);
+    CuAssertIntEquals(t, 40, notes[1].duration);
+
+    // The volume is scaled by the current Tx volume at playback time
+    Transmitter.volume = 5;
+    CuAssertIntEquals(t, 0, MUSIC_GetSound(MUSIC_VOLUME));
+    CuAssertIntEquals(t, 50, Volume);
+
+    CuAssertIntEquals(t, 1, MUSIC_GetSound(MUSIC_TOTAL));
+    Transmitter.volume = old_volume;
+}
@@ -0,0 +1,33 @@
+#include "CuTest.h"
+
+void TestProtoSpiBurst(CuTest *t)
+{
+    const u8 payload[12] = {0x55, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xaa, 0xff};
+    const u8 *data;
+    unsigned bursts;
+    u8 rx[8];
+
+    PROTOSPI_ClearCapture();
+    NRF24L01_WritePayload((u8 *)payload, sizeof(payload));
+    CuAssertIntEquals(t, 1 + sizeof(payload), PROTOSPI_GetCapture(&data, &bursts));
+    CuAssertIntEquals(t, 1, bursts);
+    CuAssertIntEquals(t, 0xA0, data[0]);    // W_TX_PAYLOAD
+    CuAssertTrue(t, memcmp(data + 1, payload, sizeof(payload)) == 0);
+
+    // Reads clock out 0x00, the simulated chip has nothing received
+    memset(rx, 0x55, sizeof(rx));
+    PROTOSPI_ClearCapture();
+    NRF24L01_ReadPayload(rx, sizeof(rx));
+    CuAssertIntEquals(t, 1 + sizeof(rx), PROTOSPI_GetCapture(&data, &bursts));
+    CuAssertIntEquals(t, 1, bursts);
+    CuAssertIntEquals(t, 0x61, data[0]);    // R_RX_PAYLOAD
+    for (unsigned i = 0; i < sizeof(rx); i++) {
+        CuAssertIntEquals(t, 0x00, data[1 + i]);
+        CuAssertIntEquals(t, 0x00, rx[i]);
+    }
+
+    // A zero length burst sends nothing
+    PROTOSPI_ClearCapture();
+    PROTOSPI_xfer_burst(payload, NULL, 0);
+    CuAssertIntEquals(t, 0, PROTOSPI_GetCapture(NULL, NULL));
+}
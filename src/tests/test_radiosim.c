@@ -0,0 +1,105 @@
+#include "CuTest.h"
+
+void TestRadioSimNrf24l01(CuTest *t)
+{
+    u8 packet[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    u8 rx[8];
+
+    RADIOSIM_Reset(NRF24L01);
+    RADIOSIM_ClearStats();
+    NRF24L01_WriteReg(NRF24L01_05_RF_CH, 40);
+    NRF24L01_SetTxRxMode(TX_EN);
+    NRF24L01_FlushTx();
+    NRF24L01_WritePayload(packet, sizeof(packet));
+    CuAssertTrue(t, NRF24L01_ReadReg(NRF24L01_07_STATUS) & (1 << NRF24L01_07_TX_DS));
+    const struct RadioSimStats *stats = RADIOSIM_Stats(NRF24L01);
+    CuAssertIntEquals(t, 1, stats->tx_packets);
+    CuAssertIntEquals(t, 40, stats->channel);
+    CuAssertIntEquals(t, sizeof(packet), stats->last_len);
+    CuAssertTrue(t, memcmp(stats->last_packet, packet, sizeof(packet)) == 0);
+
+    // The response is delivered once the protocol polls in RX mode
+    const u8 response[4] = {0xde, 0xad, 0xbe, 0xef};
+    CuAssertIntEquals(t, 1, RADIOSIM_QueueRx(NRF24L01, response, sizeof(response)));
+    NRF24L01_SetTxRxMode(RX_EN);
+    CuAssertTrue(t, NRF24L01_ReadReg(NRF24L01_07_STATUS) & (1 << NRF24L01_07_RX_DR));
+    NRF24L01_ReadPayload(rx, sizeof(response));
+    CuAssertTrue(t, memcmp(rx, response, sizeof(response)) == 0);
+    CuAssertIntEquals(t, 0x01, NRF24L01_ReadReg(NRF24L01_17_FIFO_STATUS) & 0x01);
+    CuAssertIntEquals(t, 1, stats->rx_packets);
+}
+
+void TestRadioSimXN297(CuTest *t)
+{
+    const u8 addr[5] = {0x12, 0x34, 0x56, 0x78, 0x9a};
+    u8 msg[6] = {0x10, 0x20, 0x30, 0x40, 0x50, 0x60};
+    u8 dec_addr[5], dec_msg[32];
+
+    for (unsigned aw = 3; aw <= 5; aw++) {
+        for (int scramble = 0; scramble < 2; scramble++) {
+            RADIOSIM_Reset(NRF24L01);
+            NRF24L01_SetTxRxMode(TX_EN);
+            XN297_SetTXAddr(addr, aw);
+            XN297_SetScrambledMode(scramble);
+            XN297_Configure((1 << NRF24L01_00_EN_CRC) | (1 << NRF24L01_00_PWR_UP));
+            XN297_WritePayload(msg, sizeof(msg));
+            const struct RadioSimStats *stats = RADIOSIM_Stats(NRF24L01);
+            CuAssertIntEquals(t, sizeof(msg),
+                RADIOSIM_DecodeXN297(stats->last_packet, stats->last_len, aw, dec_addr, dec_msg));
+            CuAssertTrue(t, memcmp(dec_addr, addr, aw) == 0);
+            CuAssertTrue(t, memcmp(dec_msg, msg, sizeof(msg)) == 0);
+        }
+    }
+}
+
+void TestRadioSimOtherChips(CuTest *t)
+{
+    u8 packet[10] = {0xa0, 0xa1, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9};
+    u8 rx[12];
+    const struct RadioSimStats *stats;
+
+    RADIOSIM_ClearStats();
+    CuAssertIntEquals(t, 1, CYRF_Reset());
+    CYRF_ConfigRFChannel(0x21);
+    CYRF_WriteDataPacketLen(packet, sizeof(packet));
+    CYRF_ConfigRFChannel(0x35);
+    CYRF_WriteDataPacketLen(packet, sizeof(packet));
+    stats = RADIOSIM_Stats(CYRF6936);
+    CuAssertIntEquals(t, 2, stats->tx_packets);
+    CuAssertIntEquals(t, 1, stats->hops);
+    CuAssertIntEquals(t, 0x35, stats->channel);
+    CuAssertTrue(t, memcmp(stats->last_packet, packet, sizeof(packet)) == 0);
+    RADIOSIM_QueueRx(CYRF6936, packet, 4);
+    CYRF_StartReceive();
+    CuAssertIntEquals(t, 4, CYRF_ReadRegister(CYRF_09_RX_COUNT));
+    CYRF_ReadDataPacketLen(rx, 4);
+    CuAssertTrue(t, memcmp(rx, packet, 4) == 0);
+
+    CuAssertIntEquals(t, 1, CC2500_Reset());
+    CC2500_WriteReg(CC2500_0A_CHANNR, 7);
+    CC2500_WriteData(packet, sizeof(packet));
+    stats = RADIOSIM_Stats(CC2500);
+    CuAssertIntEquals(t, 1, stats->tx_packets);
+    CuAssertIntEquals(t, 7, stats->channel);
+    CuAssertIntEquals(t, sizeof(packet), stats->last_len);
+    RADIOSIM_QueueRx(CC2500, packet, 6);
+    CC2500_Strobe(CC2500_SRX);
+    CuAssertIntEquals(t, 6 + 2, CC2500_ReadReg(CC2500_3B_RXBYTES));   // plus RSSI and LQI
+    CC2500_ReadData(rx, 8);
+    CuAssertTrue(t, memcmp(rx, packet, 6) == 0);
+    CuAssertIntEquals(t, 0x80, rx[7] & 0x80);   // CRC_OK
+
+    CuAssertIntEquals(t, 1, A7105_Reset());
+    A7105_WriteData(packet, sizeof(packet), 100);
+    stats = RADIOSIM_Stats(A7105);
+    CuAssertIntEquals(t, 1, stats->tx_packets);
+    CuAssertIntEquals(t, 100, stats->channel);
+    CuAssertTrue(t, memcmp(stats->last_packet, packet, sizeof(packet)) == 0);
+    A7105_Strobe(A7105_RX);
+    CuAssertIntEquals(t, 0x01, A7105_ReadReg(0x00) & 0x01);     // still waiting
+    RADIOSIM_QueueRx(A7105, packet, 5);
+    A7105_Strobe(A7105_RX);
+    CuAssertIntEquals(t, 0x00, A7105_ReadReg(0x00) & 0x01);
+    A7105_ReadData(rx, 5);
+    CuAssertTrue(t, memcmp(rx, packet, 5) == 0);
+}
@@ -0,0 +1,109 @@
+#include "CuTest.h"
+
+extern u8 test_flash[TEST_FLASH_SIZE];
+extern unsigned test_flash_reads;
+extern unsigned test_flash_writes;
+
+static void flash_fill()
+{
+    STORAGE_CacheReset();
+    for (unsigned i = 0; i < sizeof(test_flash); i++)
+        test_flash[i] = i * 7 + (i >> 8);
+    test_flash_reads = 0;
+    test_flash_writes = 0;
+}
+
+void TestStorageCacheRead(CuTest *t)
+{
+    u8 buf[600];
+    flash_fill();
+
+    STORAGE_CacheReadBytes(0x1010, 20, buf);
+    CuAssertIntEquals(t, 1, test_flash_reads);
+    CuAssertTrue(t, memcmp(buf, test_flash + 0x1010, 20) == 0);
+    STORAGE_CacheReadBytes(0x10f0, 16, buf);
+    CuAssertIntEquals(t, 1, test_flash_reads);
+
+    // A sequential read across the line boundary also fetches the line after it
+    STORAGE_CacheReadBytes(0x1100, 8, buf);
+    CuAssertIntEquals(t, 3, test_flash_reads);
+    STORAGE_CacheReadBytes(0x1200, 100, buf);
+    CuAssertIntEquals(t, 3, test_flash_reads);
+    CuAssertTrue(t, memcmp(buf, test_flash + 0x1200, 100) == 0);
+
+    // Read-ahead stops at the end of the sector
+    STORAGE_CacheReset();
+    test_flash_reads = 0;
+    STORAGE_CacheReadBytes(0x1ef0, 0x10, buf);
+    STORAGE_CacheReadBytes(0x1f00, 0x10, buf);
+    CuAssertIntEquals(t, 2, test_flash_reads);
+
+    // Whole lines of large reads go straight to storage and are not kept
+    STORAGE_CacheReset();
+    test_flash_reads = 0;
+    STORAGE_CacheReadBytes(0x2080, sizeof(buf), buf);
+    CuAssertTrue(t, memcmp(buf, test_flash + 0x2080, sizeof(buf)) == 0);
+    CuAssertIntEquals(t, 4, test_flash_reads);
+    STORAGE_CacheReadBytes(0x2100, 16, buf);
+    CuAssertIntEquals(t, 5, test_flash_reads);
+
+    // The least recently used line is replaced
+    STORAGE_CacheReset();
+    for (int i = 0; i < STORAGE_CACHE_LINES; i++)
+        STORAGE_CacheReadBytes(0x3000 + i * 0x400, 4, buf);
+    STORAGE_CacheReadBytes(0x3000, 4, buf);
+    test_flash_reads = 0;
+    STORAGE_CacheReadBytes(0x5000, 4, buf);
+    STORAGE_CacheReadBytes(0x3000, 4, buf);
+    CuAssertIntEquals(t, 1, test_flash_reads);
+    STORAGE_CacheReadBytes(0x3400, 4, buf);
+    CuAssertIntEquals(t, 2, test_flash_reads);
+}
+
+void TestStorageCacheReadStopCR(CuTest *t)
+{
+    u8 buf[64];
+    flash_fill();
+    memcpy(test_flash + 0x10fa, "name=abc\nx", 10);
+    CuAssertIntEquals(t, 9, STORAGE_CacheReadBytesStopCR(0x10fa, sizeof(buf), buf));
+    CuAssertTrue(t, memcmp(buf, "name=abc\n", 9) == 0);
+    CuAssertIntEquals(t, 4, STORAGE_CacheReadBytesStopCR(0x10fa, 4, buf));
+}
+
+void TestStorageCacheWrite(CuTest *t)
+{
+    u8 data[300], buf[300];
+    flash_fill();
+    for (unsigned i = 0; i < sizeof(data); i++)
+        data[i] = 0xA0 ^ i;
+
+    // Fill the cache first so the writes must replace stale lines
+    STORAGE_CacheReadBytes(0x4000, 16, buf);
+    STORAGE_CacheEraseSector(0x4000);
+    for (int i = 0; i < 3; i++)
+        STORAGE_CacheWriteBytes(0x4000 + i * 100, 100, data + i * 100);
+    // The first page was programmed once when the writes moved past it
+    CuAssertIntEquals(t, 1, test_flash_writes);
+    STORAGE_CacheReadBytes(0x4000, sizeof(buf), buf);
+    CuAssertIntEquals(t, 2, test_flash_writes);
+    CuAssertTrue(t, memcmp(buf, data, sizeof(data)) == 0);
+    CuAssertTrue(t, memcmp(test_flash + 0x4000, data, sizeof(data)) == 0);
+
+    // Pending data goes out on flush, and is dropped if its sector is erased
+    STORAGE_CacheWriteBytes(0x4200, 10, data);
+    CuAssertIntEquals(t, 2, test_flash_writes);
+    STORAGE_CacheFlush();
+    CuAssertIntEquals(t, 3, test_flash_writes);
+    STORAGE_CacheWriteBytes(0x4300, 10, data);
+    STORAGE_CacheEraseSector(0x4000);
+    STORAGE_CacheFlush();
+    CuAssertIntEquals(t, 3, test_flash_writes);
+    STORAGE_CacheReadBytes(0x4000, 16, buf);
+    CuAssertIntEquals(t, 0, buf[0] | buf[15]);
+
+    // ... but programmed before another sector is erased, so the flash sees the order it was given
+    STORAGE_CacheWriteBytes(0x3000, 10, data);
+    STORAGE_CacheEraseSector(0x4000);
+    CuAssertIntEquals(t, 4, test_flash_writes);
+    CuAssertTrue(t, memcmp(test_flash + 0x3000, data, 10) == 0);
+}
@@ -0,0 +1,193 @@
+#include "CuTest.h"
+
+void TestTelemetryFrameQueue(CuTest *t)
+{
+    u8 frame[64], out[64];
+    for (unsigned i = 0; i < sizeof(frame); i++)
+        frame[i] = i + 1;
+
+    TELEMETRY_ResetFrames();
+    CuAssertIntEquals(t, 0, TELEMETRY_NextFrame(out, sizeof(out)));
+
+    // Run enough frames through to wrap the indices several times
+    for (int i = 0; i < 100; i++) {
+        u8 len = 5 + i % 40;
+        TELEMETRY_QueueFrame(frame, len);
+        TELEMETRY_QueueFrame(frame + 1, 9);
+        CuAssertIntEquals(t, 1, TELEMETRY_FramesQueued());
+        CuAssertIntEquals(t, len, TELEMETRY_NextFrame(out, sizeof(out)));
+        CuAssertTrue(t, memcmp(out, frame, len) == 0);
+        CuAssertIntEquals(t, 9, TELEMETRY_NextFrame(out, sizeof(out)));
+        CuAssertTrue(t, memcmp(out, frame + 1, 9) == 0);
+        CuAssertIntEquals(t, 0, TELEMETRY_FramesQueued());
+    }
+
+    // A full queue drops new frames but keeps the queued ones intact
+    for (int i = 0; i < 10; i++)
+        TELEMETRY_QueueFrame(frame, 63);
+    for (int i = 0; i < 3; i++) {
+        CuAssertIntEquals(t, 63, TELEMETRY_NextFrame(out, sizeof(out)));
+        CuAssertTrue(t, memcmp(out, frame, 63) == 0);
+    }
+    CuAssertIntEquals(t, 0, TELEMETRY_NextFrame(out, sizeof(out)));
+
+    // Frames too big for the reader are skipped
+    TELEMETRY_QueueFrame(frame, 20);
+    TELEMETRY_QueueFrame(frame, 8);
+    CuAssertIntEquals(t, 8, TELEMETRY_NextFrame(out, 10));
+    CuAssertIntEquals(t, 0, TELEMETRY_FramesQueued());
+}
+
+void TestTelemetryHistory(CuTest *t)
+{
+    s32 values[TELEM_HISTORY_SAMPLES];
+    const int src = TELEM_DEVO_VOLT1;
+    u32 now = 0;
+
+    TELEMETRY_HistoryUntrack(src);
+    CuAssertIntEquals(t, 1, TELEMETRY_HistoryTrack(src));
+    CuAssertIntEquals(t, 0, TELEMETRY_HistoryGet(src, TELEM_HISTORY_1SEC, values, TELEM_HISTORY_SAMPLES));
+    CuAssertTrue(t, TELEMETRY_HistoryStats(src) == NULL);
+
+    // 10 samples per second ramping by 1 each second
+    history_next_ms = 1000;
+    for (int sec = 0; sec < 25; sec++) {
+        for (int i = 0; i < 10; i++) {
+            Telemetry.value[src] = 1000 + sec;
+            TELEMETRY_SetUpdated(src);
+            history_sample(now);
+            now += 100;
+        }
+    }
+    history_sample(now);
+
+    int count = TELEMETRY_HistoryGet(src, TELEM_HISTORY_1SEC, values, TELEM_HISTORY_SAMPLES);
+    CuAssertIntEquals(t, 25, count);
+    for (int i = 0; i < count; i++)
+        CuAssertIntEquals(t, 1000 + i, values[i]);
+    CuAssertIntEquals(t, 3, TELEMETRY_HistoryGet(src, TELEM_HISTORY_1SEC, values, 3));
+    CuAssertIntEquals(t, 1024, values[2]);
+
+    count = TELEMETRY_HistoryGet(src, TELEM_HISTORY_10SEC, values, TELEM_HISTORY_SAMPLES);
+    CuAssertIntEquals(t, 2, count);
+    CuAssertIntEquals(t, 1004, values[0]);  // average of 1000..1009
+    CuAssertIntEquals(t, 1014, values[1]);
+
+    const struct TelemetryStats *stats = TELEMETRY_HistoryStats(src);
+    CuAssertTrue(t, stats != NULL);
+    CuAssertIntEquals(t, 1000, stats->min);
+    CuAssertIntEquals(t, 1024, stats->max);
+    CuAssertIntEquals(t, 1012, stats->mean);
+    CuAssertIntEquals(t, 250, stats->count);
+
+    // A source that stops updating leaves a gap rather than repeating its value
+    history_sample(now += 1000);
+    CuAssertIntEquals(t, 25, TELEMETRY_HistoryGet(src, TELEM_HISTORY_1SEC, values, TELEM_HISTORY_SAMPLES));
+    CuAssertIntEquals(t, 250, TELEMETRY_HistoryStats(src)->count);
+
+    // Large swings are kept exactly
+    Telemetry.value[src] = 100000;
+    TELEMETRY_SetUpdated(src);
+    history_sample(now += 1000);
+    Telemetry.value[src] = -100000;
+    TELEMETRY_SetUpdated(src);
+    history_sample(now += 1000);
+    count = TELEMETRY_HistoryGet(src, TELEM_HISTORY_1SEC, values, TELEM_HISTORY_SAMPLES);
+    CuAssertIntEquals(t, 27, count);
+    CuAssertIntEquals(t, 1024, values[24]);
+    CuAssertIntEquals(t, 100000, values[25]);
+    CuAssertIntEquals(t, -100000, values[26]);
+    CuAssertIntEquals(t, -100000, TELEMETRY_HistoryStats(src)->min);
+
+    TELEMETRY_HistoryReset();
+    CuAssertIntEquals(t, 0, TELEMETRY_HistoryGet(src, TELEM_HISTORY_1SEC, values, TELEM_HISTORY_SAMPLES));
+    TELEMETRY_HistoryUntrack(src);
+
+    // Once all slots are taken, the first one tracked is reused
+    for (int i = 0; i <= TELEM_HISTORY_SLOTS; i++)
+        CuAssertIntEquals(t, 1, TELEMETRY_HistoryTrack(TELEM_DEVO_TEMP1 + i));
+    CuAssertTrue(t, history_find(TELEM_DEVO_TEMP1) == NULL);
+    CuAssertTrue(t, history_find(TELEM_DEVO_TEMP1 + TELEM_HISTORY_SLOTS) != NULL);
+    for (int i = 0; i <= TELEM_HISTORY_SLOTS; i++)
+        TELEMETRY_HistoryUntrack(TELEM_DEVO_TEMP1 + i);
+    Telemetry.value[src] = 0;
+}
+
+void TestTelemetryHistoryBlocks(CuTest *t)
+{
+    s32 values[TELEM_HISTORY_SAMPLES];
+    const int src = TELEM_DEVO_VOLT1;
+
+    TELEMETRY_HistoryUntrack(src);
+    TELEMETRY_HistoryTrack(src);
+    struct history_slot *slot = history_find(src);
+    struct history_ring *ring = &slot->ring[TELEM_HISTORY_1SEC];
+
+    // A slow climb wraps the ring, starting a new block every 32767 or so
+    for (int i = 0; i < 3 * TELEM_HISTORY_SAMPLES; i++)
+        history_push(slot, TELEM_HISTORY_1SEC, i * 1000);
+    CuAssertIntEquals(t, TELEM_HISTORY_SAMPLES, TELEMETRY_HistoryGet(src, TELEM_HISTORY_1SEC, values, TELEM_HISTORY_SAMPLES));
+    for (int i = 0; i < TELEM_HISTORY_SAMPLES; i++)
+        CuAssertIntEquals(t, (2 * TELEM_HISTORY_SAMPLES + i) * 1000, values[i]);
+    CuAssertTrue(t, ring->block_count > 1);
+
+    // Values that never fit a block keep only the last HISTORY_BLOCKS of them
+    for (int i = 0; i < 10; i++)
+        history_push(slot, TELEM_HISTORY_1SEC, (i & 1) ? -100000 : 100000);
+    int count = TELEMETRY_HistoryGet(src, TELEM_HISTORY_1SEC, values, TELEM_HISTORY_SAMPLES);
+    CuAssertIntEquals(t, HISTORY_BLOCKS, count);
+    for (int i = 0; i < count; i++)
+        CuAssertIntEquals(t, (i & 1) ? -100000 : 100000, values[i]);
+
+    // A steady value fills the ring again
+    for (int i = 0; i < TELEM_HISTORY_SAMPLES; i++)
+        history_push(slot, TELEM_HISTORY_1SEC, 5000 + i);
+    CuAssertIntEquals(t, TELEM_HISTORY_SAMPLES, TELEMETRY_HistoryGet(src, TELEM_HISTORY_1SEC, values, TELEM_HISTORY_SAMPLES));
+    CuAssertIntEquals(t, 5000, values[0]);
+    CuAssertIntEquals(t, 5000 + TELEM_HISTORY_SAMPLES - 1, values[TELEM_HISTORY_SAMPLES - 1]);
+
+    TELEMETRY_HistoryUntrack(src);
+}
+
+void TestTelemetryAlarmTrigger(CuTest *t)
+{
+    struct TelemetryAlarm saved = Model.alarms[0];
+    struct TelemetryAlarm *alarm = &Model.alarms[0];
+    const int src = TELEM_DEVO_VOLT1;
+
+    memset(alarm, 0, sizeof(*alarm));
+    alarm->src = src;
+    alarm->above = 1;     // alarm at or below the limit
+    alarm->value = 1000;
+    compile_alarms();
+    memset((void *)alarm_pending, 0, sizeof(alarm_pending));
+
+    // Only updates of the watched value mark the alarm
+    TELEMETRY_SetUpdated(TELEM_DEVO_VOLT2);
+    CuAssertIntEquals(t, 0, alarm_pending[0]);
+    Telemetry.value[src] = 900;
+    TELEMETRY_SetUpdated(src);
+    CuAssertIntEquals(t, 1, alarm_pending[0]);
+    CuAssertIntEquals(t, 0, alarm_pending[1]);
+
+    // Debounce: a single low sample doesn't set the alarm
+    check_alarm(0, 0);
+    CuAssertIntEquals(t, 0, alarm->state);
+    check_alarm(0, 0);
+    CuAssertIntEquals(t, 1, alarm->state);
+    CuAssertIntEquals(t, 1, alarm_active);
+
+    // Hysteresis: just above the limit keeps it set
+    Telemetry.value[src] = 1020;
+    check_alarm(0, 0);
+    CuAssertIntEquals(t, 1, alarm->state);
+    Telemetry.value[src] = 1040;
+    check_alarm(0, 0);
+    CuAssertIntEquals(t, 0, alarm->state);
+    CuAssertIntEquals(t, 0, alarm_active);
+
+    *alarm = saved;
+    Telemetry.value[src] = 0;
+    compile_alarms();
+    memset((void *)alarm_pending, 0, sizeof(alarm_pending));
+}
@@ -20,6 +20,8 @@
 #include "config/tx.h"
 #include <stdlib.h>
 
+#define PERMANENT_SAVE_MSEC 5000  //Have a running permanent timer saved this often
+
 static u8 timer_state[NUM_TIMERS];
 static s32 timer_val[NUM_TIMERS];
 static s32 last_time[NUM_TIMERS];
@@ -63,6 +65,8 @@ void TIMER_StartStop(unsigned timer)
     timer_state[timer] ^= 1;
     if(timer_state[timer]) {
         last_time[timer] = CLOCK_getms();
+    } else if (Model.timer[timer].type == TIMER_PERMANENT) {
+        CONFIG_MarkChanged();  //Save the permanent timer where it stopped
     }
 }
 
@@ -168,6 +172,8 @@ void TIMER_Update()
                 if (new_state != timer_state[i]) {
                     if (new_state)
                         last_time[i] = t;
+                    else if (Model.timer[i].type == TIMER_PERMANENT)
+                        CONFIG_MarkChanged();
                     timer_state[i] = new_state;
                 }
             }
@@ -182,6 +188,8 @@ void TIMER_Update()
                 timer_val[i] += delta;
                 if( timer_val[i] >= 359999900) // Reset when 99h59mn59sec
                     timer_val[i] = 0 ;
+                if (timer_val[i] / PERMANENT_SAVE_MSEC != Model.timer[i].val / PERMANENT_SAVE_MSEC)
+                    CONFIG_MarkChanged();
                 Model.timer[i].val = timer_val[i];
             } else if (Model.timer[i].type == TIMER_STOPWATCH || Model.timer[i].type == TIMER_STOPWATCH_PROP) {
                 timer_val[i] += delta;
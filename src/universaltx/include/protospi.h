@@ -6,6 +6,7 @@
 #include "ports.h"
 
 u8 PROTOSPI_read3wire();
+void PROTOSPI_xfer_burst(const u8 *tx, u8 *rx, unsigned len);
 uint8_t spi_xfer8(uint32_t spi, uint8_t data);
 
 #define spi_xfer             DO_NOT_USE
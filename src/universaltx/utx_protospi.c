@@ -61,6 +61,15 @@ u8 PROTOSPI_read3wire(){
     return data;
 }
 
+void PROTOSPI_xfer_burst(const u8 *tx, u8 *rx, unsigned len)
+{
+    for (unsigned i = 0; i < len; i++) {
+        u8 data = PROTOSPI_xfer(tx ? tx[i] : 0x00);
+        if (rx)
+            rx[i] = data;
+    }
+}
+
 void exti4_15_isr(void)
 {
     if (exti_get_flag_status(PASSTHRU_CSN.pin)) {
@@ -14,20 +14,42 @@ class Capture(object):
         self.elem_names = []
         self.header_size = 3
         self.capture_size = 0
+        self.record_size = 0
+        self.version = 0
         self.data = []
+        self.seq = []
+        self.time = []
+        self.gaps = 0
 
     def __init__(self, data):
         self.init()
+        self.version = data[0]
         header_mask_size = self.to_model(data[1])
         self.to_rate(data[2])
         self.header_mask = data[3:3+header_mask_size]
         self.capture_size = self.parse_size(self.header_mask)
         self.header_size = header_mask_size + 3
+        # Version 6 headers end with the u16 sample period in ms
+        if self.version >= 0x06:
+            period = data[self.header_size] | (data[self.header_size + 1] << 8)
+            self.rate = "%d ms" % period if period < 1000 else "%d sec" % (period // 1000)
+            self.header_size += 2
+        # Version 5 records start with a u16 sequence number and u32 timestamp(ms)
+        self.record_size = 6 if self.version >= 0x05 else 0
     def add_elem(self, data):
         item = []
+        if self.record_size:
+            seq = data[0] | (data[1] << 8)
+            if self.seq and seq != (self.seq[-1] + 1) & 0xffff:
+                missing = (seq - self.seq[-1] - 1) & 0xffff
+                sys.stderr.write("Gap: %d record(s) missing before sequence %d\n" % (missing, seq))
+                self.gaps += missing
+            self.seq.append(seq)
+            self.time.append(data[2] | (data[3] << 8) | (data[4] << 16) | (data[5] << 24))
+            data = data[self.record_size:]
         idx = 0;
         for i in range(self.max_elem):
-            if not (self.header_mask[(i / 8)] & (1 << (i % 8))):
+            if not (self.header_mask[(i // 8)] & (1 << (i % 8))):
                 continue
             size = self.get_size(i)
             item.append(self.format_data(i, data[idx:]))
@@ -104,7 +126,7 @@ class Capture(object):
 
         self.elem_names = timers + telem_volt + telem_temp + telem_rpm + telem_extra \
                           + inp + outch + virtch + ppm + gps_loc + gps_alt + gps_speed + gps_time + rtc
-        return (7 + self.max_elem) / 8
+        return (7 + self.max_elem) // 8
     def to_rate(self, value):
         if value == 0:
             self.rate = "1 sec"
@@ -141,15 +163,15 @@ class Capture(object):
             return "%d" % (data[0] - 0x100 if (data[0] & 0x80) else data[0])
         if type == self.GPS_LOC:
             value = data[0] + (data[1] << 8) + (data[2] << 16) + (data[3] << 24)
-            h = value / 1000 / 60 / 60;
-            m = (value - h * 1000 * 60 * 60) / 1000 / 60;
-            s = (value - h * 1000 * 60 * 60 - m * 1000 * 60) / 1000;
+            h = value // 1000 // 60 // 60;
+            m = (value - h * 1000 * 60 * 60) // 1000 // 60;
+            s = (value - h * 1000 * 60 * 60 - m * 1000 * 60) // 1000;
             ss = value % 1000;
             str = "%03d %02d %02d.%03d" % (h, m, s, ss)
             value = data[4] + (data[5] << 8) + (data[6] << 16) + (data[7] << 24)
-            h = value / 1000 / 60 / 60;
-            m = (value - h * 1000 * 60 * 60) / 1000 / 60;
-            s = (value - h * 1000 * 60 * 60 - m * 1000 * 60) / 1000;
+            h = value // 1000 // 60 // 60;
+            m = (value - h * 1000 * 60 * 60) // 1000 // 60;
+            s = (value - h * 1000 * 60 * 60 - m * 1000 * 60) // 1000;
             ss = value % 1000;
             return "%s,%03d %02d %02d.%03d" % (str, h, m, s, ss)
         if type == self.GPS_ALT or type == self.GPS_SPEED:
@@ -170,10 +192,10 @@ class Capture(object):
             daysInYear = [ [ 0,31,59,90,120,151,181,212,243,273,304,334,365],
                            [ 0,31,60,91,121,152,182,213,244,274,305,335,366] ]
 
-            days = value / DAYSEC;
-            year = (4*days) / 1461; # = days/365.25
+            days = value // DAYSEC;
+            year = (4*days) // 1461; # = days/365.25
             leap = 1 if year % 4 == 0 else 0
-            days = year * 365 + year / 4
+            days = year * 365 + year // 4
             days -= 1 if (year != 0 and days > daysInYear[leap][2]) else 0  #leap year correction for RTC_STARTYEAR
             month = 0;
             for month in range(0, 12):
@@ -182,24 +204,28 @@ class Capture(object):
             day = days - daysInYear[leap][month]
             month += 1
             sec = value % 60
-            min = (value / 60) % 60
-            hour = (value / 3600) % 24
+            min = (value // 60) % 60
+            hour = (value // 3600) % 24
             return "%02d:%02d:%02d %04d-%02d-%02d" % (hour, min, sec, 2012 + year, month, day)
         return "Unknown(%d)" %(data[0])
 
     def parse_size(self, data):
         self.num_elem = 0
         for i in range(self.max_elem):
-            if data[(i / 8)] & (1 << (i % 8)):
+            if data[(i // 8)] & (1 << (i % 8)):
                 self.num_elem += self.get_size(i)
         return self.num_elem
     def write_csv(self):
         head = []
+        if self.record_size:
+            head = ["Seq", "Time(ms)"]
         for i in range(self.max_elem):
-            if self.header_mask[(i / 8)] & (1 << (i % 8)):
+            if self.header_mask[(i // 8)] & (1 << (i % 8)):
                 head.append(self.elem_names[i])
         out = [",".join(head)+"\n"]
-        for d in self.data:
+        for n, d in enumerate(self.data):
+            if self.record_size:
+                d = [self.seq[n], self.time[n]] + d
             out.append(",".join(str(x) for x in d) + "\n")
         return out
         
@@ -248,8 +274,8 @@ def main():
     info = parse_file(opt.bin)
     if opt.list:
         for i in range(len(info)):
-            printf("%3d: %10s (rate=%s): %5d samples (%d)\n", i+1,
-                   info[i].model, info[i].rate, len(info[i].data), info[i].num_elem)
+            printf("%3d: %10s (rate=%s): %5d samples (%d) %d missing\n", i+1,
+                   info[i].model, info[i].rate, len(info[i].data), info[i].num_elem, info[i].gaps)
         return
     out = []
     if opt.write:
@@ -278,9 +304,9 @@ def parse_file(bin):
             return info
         if data[idx] == 0xff:
             info[-1].add_elem(data[idx+1:])
-            idx += info[-1].capture_size+1
+            idx += info[-1].record_size+info[-1].capture_size+1
             continue
-        if data[idx] != 0x03:
+        if data[idx] < 0x03 or data[idx] > 0x06:
             printf("Cannot handle API version 0x%02x\n", data[idx])
             return info
         info.append(Capture(data[idx:]))